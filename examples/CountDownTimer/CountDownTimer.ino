@@ -1,7 +1,7 @@
 /*
     Name:       CountDownTimer.ino
     Created:	23.07.2018 15:14:18
-	Updated:	08.09.2018
+	Updated:	15.10.2026
     Author:     Dejan Gjorgjevikj <dejan.gjorgjevikj@gmail.com>
 
 An example program that uses the yaPushButton library, implementing a simple countdown timer. 
@@ -114,12 +114,7 @@ Display display;
 
 //Runtime globals
 
-// Pointer to the value to be changed by up/down button 
-// must be global as it is changed from an callback function with no arguments 
-// ToDo - implement void * as argument to the callback so no global will be needed
-int *pval;
-
-int cntDtime; // time set for countdown timer
+int cntDtime; // time set for countdown timer (changed by the +/- buttons - the context of their callbacks)
 unsigned long devicerun; // total number of milliseconds the device was running
 uint8_t durs = 5; // duration 1-99
 
@@ -134,39 +129,35 @@ inline bool valChange(T *pval, T changeBy, T lowLimit = (T)1, T upLimit = (T)99)
 	return true;
 }
 
-void pbService()
+// The callbacks get the pointer to the value to be changed by up/down button as context
+void pbService(void *pval, ButtonEvent)
 {
-	if(valChange(pval, 1, 1, 99))
+	if(valChange((int *)pval, 1, 1, 99))
 		tone(BUZZER_PIN, 8000, 20UL);
 	else
 		tone(BUZZER_PIN, 500, 40UL);
 }
 
-void mbService()
+void mbService(void *pval, ButtonEvent)
 {
-	if (valChange(pval, -1, 1, 99))
+	if (valChange((int *)pval, -1, 1, 99))
 		tone(BUZZER_PIN, 6000, 20UL);
 	else
 		tone(BUZZER_PIN, 500, 40UL);
 }
 
-// Changes a value of an integer by given value (cahangBy), checking bounds
-void UpDownSet(int &v, void(*keypess_plusB)(), void(*keypess_minusB)())
+// Sets the countdown time with the +/- buttons (their callbacks change cntDtime)
+void UpDownSet()
 {
-	// set the global pointer to point to the value to be changed by pressing the +/- button
-	pval = &v;
 	display.clear();
-	display.show(v);
+	display.show(cntDtime);
 
 	// display blinks to denote setting mode
 	display.blinkOn();
 
-	ButtonPlus.registerKeyPressCallback(keypess_plusB);
-	ButtonMinus.registerKeyPressCallback(keypess_minusB);
-
 	while (ButtonStartStop.stateChanged() != BUTTON_PRESSED) // press start button to exit setting
 	{
-		display.show(v);
+		display.show(cntDtime);
 		ButtonPlus.handle();
 		ButtonMinus.handle();
 		delay(1);
@@ -210,9 +201,12 @@ void toogleLED()
 		LedOff();   // turn the LED off 
 }
 
-byte CountDownMin(int &m) // in minutes
+// Counts down cntDtime minutes, the +/- buttons change the remaining time through cntDtime
+// on stop cntDtime is left at the remaining minutes
+byte CountDownMin()
 {
-	unsigned long t = m * 60L * 1000L; // in milliseconds
+	int setTime = cntDtime; // restored when the countdown ends regularly
+	unsigned long t = cntDtime * 60L * 1000L; // in milliseconds
 	unsigned long start = millis();
 	/*unsigned*/ long endt = start + t;
 	unsigned long us; // current ms
@@ -248,21 +242,21 @@ byte CountDownMin(int &m) // in minutes
 		}
 		if (ButtonStartStop.stateChanged() == BUTTON_PRESSED)
 		{
-			m = remm;
+			cntDtime = remm;
 			return (1); // stopped
 		}
 
 		// if button + or - is pressed (buy not both simultaneously) increase / decrease time by 1 minute
 		if (!(ButtonPlus.isPressed() && ButtonMinus.isPressed()))
 		{
-			int premm = remm;
-			pval = &remm;
+			cntDtime = remm; // the callbacks change the remaining minutes
 			ButtonPlus.handle();
 			ButtonMinus.handle();
-			if (premm != remm) // increased / decreased
-				valChange(&endt, (remm - premm) * 1000L * 60L, 1000 * 60L, 99000 * 60L);
+			if (cntDtime != remm) // increased / decreased
+				valChange(&endt, (cntDtime - remm) * 1000L * 60L, 1000 * 60L, 99000 * 60L);
 		}
 	}
+	cntDtime = setTime;
 	return(0); // finished regularly
 }
 
@@ -313,6 +307,10 @@ void setup()
 	ButtonMinus.init();
 	ButtonStartStop.init();
 
+	// the value to be changed by pressing the +/- button is passed to the callbacks as context - registered once
+	ButtonPlus.registerKeyEventCallback(pbService, &cntDtime);
+	ButtonMinus.registerKeyEventCallback(mbService, &cntDtime);
+
 	cntDtime = durs;
 	tone(BUZZER_PIN, 2000, 200);
 	delay(200);
@@ -320,7 +318,7 @@ void setup()
 
 void loop()
 {
-	UpDownSet(cntDtime, pbService, mbService);
+	UpDownSet();
 	durs = cntDtime;
 	Serial.print("Set time: ");
 	Serial.print(cntDtime);
@@ -331,7 +329,7 @@ void loop()
 	tone(BUZZER_PIN, 2000, 100UL);
 
 	DeviceOn();
-	byte r = CountDownMin(cntDtime);
+	byte r = CountDownMin();
 	DeviceOff();
 
 	if (r == 1) // stopped prematurely
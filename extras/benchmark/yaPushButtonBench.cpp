@@ -0,0 +1,574 @@
+// yaPushButtonBench.cpp
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// host benchmark measuring the per-call cost of stateChanged(), heldDown() and handle()
+// drives the button classes with recorded bounce waveforms on a simulated clock
+// and compares the debounce policies on a waveform with random noise spikes
+// measures the cost of a scan of a 4x4 and an 8x8 keypad matrix (per scan and per key)
+// (c) yaPushButton contributors, 2026
+//
+// Build (from this folder):
+//   g++ -O2 -std=gnu++11 -I../../src yaPushButtonBench.cpp -o yaPushButtonBench
+// Run:
+//   ./yaPushButtonBench [--calls-per-ms N] [--duration MS] [--save FILE] [--compare FILE [TOLERANCE%]]
+// --save writes the instruction count per call of each case to FILE,
+// --compare fails (exit code 1) if any case needs more than TOLERANCE% (default 5)
+// instructions per call than recorded in FILE
+// Instruction counts are read from the Linux perf counters, n/a if they are not accessible -
+// --compare then checks the ns per call against the same TOLERANCE% (give a wider one, the times are noisy)
+// and fails (exit code 2) if no case has a metric recorded in FILE and measured in this run
+
+#include <yaPushButtonHost.h>
+#include <yaPushButtonDebounce.h>
+#include <yaPushButtonMatrix.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef PushButtonHostHAL Sim;
+
+const byte PB_PIN = 2;
+
+// a press recorded on a worn tactile switch: bounces for ~4ms on press and ~6ms on release
+// (times relative to the start of the press, levels for active low button)
+static const PushButtonHostEdge pressBounce[] =
+{
+	{ 0, LOW }, { 1, HIGH }, { 1, LOW }, { 2, HIGH }, { 4, LOW }
+};
+static const PushButtonHostEdge releaseBounce[] =
+{
+	{ 0, HIGH }, { 1, LOW }, { 2, HIGH }, { 3, LOW }, { 4, HIGH }, { 6, LOW }, { 6, HIGH }
+};
+
+/// <summary> Instruction counter of the calling thread (Linux perf events) </summary>
+class InstructionCounter
+{
+	int fd;
+public:
+	InstructionCounter() : fd(-1)
+	{
+#ifdef __linux__
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+	~InstructionCounter()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+			close(fd);
+#endif
+	}
+	bool available() const { return fd >= 0; }
+	void start()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+	long long stop()
+	{
+		long long count = -1;
+#ifdef __linux__
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(fd, &count, sizeof(count)) != sizeof(count))
+				count = -1;
+		}
+#endif
+		return count;
+	}
+};
+
+/// <summary> The state the button is driven through during a benchmark case </summary>
+enum Scenario { IDLE, BOUNCING, HELD, REPEATING, NOISY };
+static const char *scenarioName[] = { "idle", "bouncing", "held", "repeating", "noisy" };
+
+// the noisy waveform - the bouncing presses with 1ms spikes to the opposite level 
+// (EMI, a long cable) at random times, on average one every noiseSpacing ms
+static const unsigned long noiseSpacing = 20;
+static const unsigned long pressCycle = 300, pressLength = 150;
+
+/// <summary> The level of the pin for the bouncing presses at time t (without noise) </summary>
+static byte bouncingLevel(unsigned long t)
+{
+	if (t < 10)
+		return HIGH;
+	unsigned long c = (t - 10) % pressCycle;
+	byte level = HIGH;
+	for (size_t i = 0; i < sizeof(pressBounce) / sizeof(pressBounce[0]) && pressBounce[i].time <= c; i++)
+		level = pressBounce[i].level;
+	for (size_t i = 0; i < sizeof(releaseBounce) / sizeof(releaseBounce[0]) && pressLength + releaseBounce[i].time <= c; i++)
+		level = releaseBounce[i].level;
+	return level;
+}
+
+/// <summary> Builds the waveform of the pin for the scenario lasting duration ms </summary>
+static std::vector<PushButtonHostEdge> makeWaveform(Scenario s, unsigned long duration)
+{
+	std::vector<PushButtonHostEdge> w;
+	PushButtonHostEdge e;
+	switch (s)
+	{
+	case IDLE: // never pressed
+		break;
+	case BOUNCING: // presses (150ms) every 300ms, each bouncing on press and release
+		for (unsigned long t = 10; t + 300 < duration; t += 300)
+		{
+			for (size_t i = 0; i < sizeof(pressBounce) / sizeof(pressBounce[0]); i++)
+			{
+				e.time = t + pressBounce[i].time; e.level = pressBounce[i].level; w.push_back(e);
+			}
+			for (size_t i = 0; i < sizeof(releaseBounce) / sizeof(releaseBounce[0]); i++)
+			{
+				e.time = t + 150 + releaseBounce[i].time; e.level = releaseBounce[i].level; w.push_back(e);
+			}
+		}
+		break;
+	case NOISY: // the bouncing presses with noise spikes (1ms resolution)
+		{
+			unsigned long seed = 12345;
+			byte last = HIGH;
+			for (unsigned long t = 0; t + pressCycle < duration; t++)
+			{
+				seed = seed * 1103515245UL + 12345UL; // the same pseudo random noise on every run
+				byte level = bouncingLevel(t);
+				if ((seed >> 16) % noiseSpacing == 0)
+					level = level == HIGH ? LOW : HIGH;
+				if (level != last)
+				{
+					e.time = t; e.level = level; w.push_back(e);
+					last = level;
+				}
+			}
+		}
+		break;
+	case HELD: // pressed and held, measured after debouncing and before autorepeat starts
+	case REPEATING: // pressed and held for the whole duration (autorepeat running)
+		for (size_t i = 0; i < sizeof(pressBounce) / sizeof(pressBounce[0]); i++)
+			w.push_back(pressBounce[i]);
+		break;
+	}
+	return w;
+}
+
+/// <summary> The time span of the scenario in which the calls are measured </summary>
+static void measuredWindow(Scenario s, unsigned long duration, unsigned long &from, unsigned long &to)
+{
+	switch (s)
+	{
+	case HELD: // after debounce (50ms) and before autorepeat (500ms)
+		from = 100; to = 450;
+		break;
+	case REPEATING: // well into (accelerated) autorepeat
+		from = 3000; to = 3000 + duration;
+		break;
+	default:
+		from = 0; to = duration;
+		break;
+	}
+}
+
+static unsigned long callbackCount;
+static void countingCallback()
+{
+	callbackCount++;
+}
+
+/// <summary> The result of one benchmark case </summary>
+struct Result
+{
+	std::string name;
+	double nsPerCall;
+	double instructionsPerCall;
+	unsigned long events;
+};
+
+static unsigned int callsPerMs = 4;
+static unsigned long benchDuration = 20000;
+static volatile unsigned long sink;
+
+/// <summary> Runs one benchmark case: constructs the button, drives it through the scenario </summary>
+/// <remarks> CALL is a functor calling the measured method, returning nonzero on an event </remarks>
+template < class BUTTON, class CALL >
+static Result run(const char *className, const char *method, Scenario s, CALL call, InstructionCounter &ic)
+{
+	unsigned long from, to;
+	measuredWindow(s, benchDuration, from, to);
+	std::vector<PushButtonHostEdge> w = makeWaveform(s, to);
+
+	Sim::reset();
+	BUTTON b(PB_PIN);
+	b.init();
+	b.registerKeyPressCallback(countingCallback);
+	Sim::setWaveform(PB_PIN, w.empty() ? NULL : &w[0], (unsigned int)w.size());
+
+	// bring the button to the state in which the measurement starts
+	for (unsigned long t = 0; t < from; t++)
+	{
+		Sim::setTime(t);
+		for (unsigned int i = 0; i < callsPerMs; i++)
+			call(b);
+	}
+
+	callbackCount = 0;
+	unsigned long events = 0;
+	unsigned long long calls = (unsigned long long)(to - from) * callsPerMs;
+	ic.start();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long t = from; t < to; t++)
+	{
+		Sim::setTime(t);
+		for (unsigned int i = 0; i < callsPerMs; i++)
+			events += call(b) ? 1 : 0;
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	long long instructions = ic.stop();
+	sink = events;
+
+	Result r;
+	r.name = std::string(className) + "::" + method + "/" + scenarioName[s];
+	r.nsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+	r.instructionsPerCall = instructions >= 0 ? (double)instructions / calls : -1.0;
+	r.events = events + callbackCount;
+	return r;
+}
+
+// the measured calls
+struct CallStateChanged
+{
+	template < class B > unsigned long operator()(B &b) const { return b.stateChanged(); }
+};
+struct CallHeldDown
+{
+	template < class B > unsigned long operator()(B &b) const { return b.heldDown(); }
+};
+struct CallHandle
+{
+	template < class B > unsigned long operator()(B &b) const { b.handle(); return 0; }
+};
+struct CallHandleFunctor // the keypresses reported to an inlined lambda instead of the callback
+{
+	template < class B > unsigned long operator()(B &b) const
+	{
+		unsigned long n = 0;
+		b.handle(Sim::now(), [&n](ButtonEvent) { n++; });
+		return n;
+	}
+};
+
+/// <summary> PushButton has no callback, adapter so it can be driven the same way </summary>
+template < template < typename > class DEBOUNCER = PushButtonTimeWindow >
+class BenchPushButton : public PushButton<false, Sim, DEBOUNCER>
+{
+public:
+	BenchPushButton(byte pbPin) : PushButton<false, Sim, DEBOUNCER>(pbPin) { }
+	void registerKeyPressCallback(void(*)()) { }
+};
+
+/// <summary> How well a debounce policy copes with the noisy waveform </summary>
+struct NoiseResult
+{
+	std::string name;
+	unsigned long presses; // real presses in the waveform
+	unsigned long reported; // presses reported
+	unsigned long falsePresses; // reported while not pressed or more than once per press
+	unsigned long missed; // real presses not reported
+	unsigned long totalLatency; // sum of the ms from the start of a press to its report (of the presses reported)
+	unsigned long worstLatency; // the longest ms from the start of a press to its report
+};
+
+/// <summary> Drives a PushButton with the debounce policy through the noisy waveform </summary>
+/// <remarks> a reported press belongs to the real press it falls in (up to 100ms after its end),
+/// any other reported press is a false trigger </remarks>
+template < class BUTTON >
+static NoiseResult noiseRun(const char *policy)
+{
+	std::vector<PushButtonHostEdge> w = makeWaveform(NOISY, benchDuration);
+	Sim::reset();
+	BUTTON b(PB_PIN);
+	b.init();
+	Sim::setWaveform(PB_PIN, &w[0], (unsigned int)w.size());
+
+	NoiseResult r;
+	r.name = policy;
+	r.presses = r.reported = r.falsePresses = r.missed = r.totalLatency = r.worstLatency = 0;
+	for (unsigned long t = 10; t + pressCycle < benchDuration; t += pressCycle)
+		r.presses++;
+	unsigned long matched = 0;
+	long lastPress = -1; // the real press already reported
+	for (unsigned long t = 0; t + pressCycle < benchDuration; t++)
+	{
+		Sim::setTime(t);
+		for (unsigned int i = 0; i < callsPerMs; i++)
+			if (b.stateChanged() == BUTTON_PRESSED)
+			{
+				r.reported++;
+				long press = t < 10 ? -1 : (long)((t - 10) / pressCycle);
+				unsigned long into = t < 10 ? 0 : (t - 10) % pressCycle;
+				if (press < 0 || into > pressLength + 100 || press == lastPress)
+					r.falsePresses++;
+				else
+				{
+					lastPress = press;
+					matched++;
+					r.totalLatency += into;
+					if (into > r.worstLatency)
+						r.worstLatency = into;
+				}
+			}
+	}
+	r.missed = r.presses - matched;
+	return r;
+}
+
+// the simulated keypad - the keys pressed in each row and the row being driven
+static byte matrixKeys[8];
+static byte matrixRow;
+static const byte matrixPins[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+/// <summary> Host HAL of the simulated keypad - driving a row pin (OUTPUT) selects the row </summary>
+struct MatrixSim : public Sim
+{
+	static void setupPin(byte pin, byte mode)
+	{
+		if (mode == OUTPUT)
+			matrixRow = pin;
+	}
+};
+
+/// <summary> Reads the columns of the simulated keypad (active low) </summary>
+static byte matrixColumns()
+{
+	return (byte)~matrixKeys[matrixRow];
+}
+
+/// <summary> Scans an N x N keypad matrix through the scenario </summary>
+/// <remarks> the keys on the diagonal (one per row and column, so no ghosting) follow the waveform of the scenario </remarks>
+template < byte N >
+static Result matrixRun(Scenario s, InstructionCounter &ic)
+{
+	unsigned long from, to;
+	measuredWindow(s, benchDuration, from, to);
+	std::vector<PushButtonHostEdge> w = makeWaveform(s, to);
+
+	Sim::reset();
+	PushButtonMatrix<N, N, MatrixSim> m(matrixPins, matrixPins);
+	m.init();
+	m.setColumnReader(matrixColumns);
+
+	size_t edge = 0;
+	byte level = HIGH;
+	unsigned long events = 0;
+	std::chrono::steady_clock::time_point start;
+	for (unsigned long t = 0; t < to; t++)
+	{
+		if (t == from)
+		{
+			events = 0;
+			ic.start();
+			start = std::chrono::steady_clock::now();
+		}
+		Sim::setTime(t);
+		while (edge < w.size() && w[edge].time <= t)
+			level = w[edge++].level;
+		for (byte r = 0; r < N; r++)
+			matrixKeys[r] = level == LOW ? (byte)(1 << r) : 0;
+		for (unsigned int i = 0; i < callsPerMs; i++)
+			m.handle(t, [&events](byte, ButtonEvent) { events++; });
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	long long instructions = ic.stop();
+	sink = events;
+
+	unsigned long long calls = (unsigned long long)(to - from) * callsPerMs;
+	char name[64];
+	snprintf(name, sizeof(name), "PushButtonMatrix<%dx%d>::handle/%s", N, N, scenarioName[s]);
+	Result r;
+	r.name = name;
+	r.nsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+	r.instructionsPerCall = instructions >= 0 ? (double)instructions / calls : -1.0;
+	r.events = events;
+	return r;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *saveFile = NULL, *compareFile = NULL;
+	double tolerance = 5.0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--calls-per-ms") && i + 1 < argc)
+			callsPerMs = (unsigned int)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--duration") && i + 1 < argc)
+			benchDuration = strtoul(argv[++i], NULL, 10);
+		else if (!strcmp(argv[i], "--save") && i + 1 < argc)
+			saveFile = argv[++i];
+		else if (!strcmp(argv[i], "--compare") && i + 1 < argc)
+		{
+			compareFile = argv[++i];
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+				tolerance = atof(argv[++i]);
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--calls-per-ms N] [--duration MS] [--save FILE] [--compare FILE [TOLERANCE%%]]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (!callsPerMs)
+		callsPerMs = 1;
+
+	InstructionCounter ic;
+	std::vector<Result> results;
+	for (int s = IDLE; s <= REPEATING; s++)
+	{
+		Scenario sc = (Scenario)s;
+		results.push_back(run<BenchPushButton<> >("PushButton", "stateChanged", sc, CallStateChanged(), ic));
+		results.push_back(run<PushButtonAutoRepeat<> >("PushButtonAutoRepeat", "heldDown", sc, CallHeldDown(), ic));
+		results.push_back(run<PushButtonAutoRepeat<> >("PushButtonAutoRepeat", "handle", sc, CallHandle(), ic));
+		results.push_back(run<PushButtonAutoRepeat<> >("PushButtonAutoRepeat", "handle(f)", sc, CallHandleFunctor(), ic));
+		results.push_back(run<PushButton2SpeedAutoRepeat<> >("PushButton2SpeedAutoRepeat", "handle", sc, CallHandle(), ic));
+		results.push_back(run<PushButtonAutoAcceleratedRepeat<> >("PushButtonAutoAcceleratedRepeat", "handle", sc, CallHandle(), ic));
+	}
+	// the cost per sample of the debounce policies
+	for (int s = BOUNCING; s <= NOISY; s += NOISY - BOUNCING)
+	{
+		Scenario sc = (Scenario)s;
+		results.push_back(run<BenchPushButton<PushButtonIntegrator> >("PushButton<Integrator>", "stateChanged", sc, CallStateChanged(), ic));
+		results.push_back(run<BenchPushButton<PushButtonShiftRegister8> >("PushButton<ShiftRegister8>", "stateChanged", sc, CallStateChanged(), ic));
+		results.push_back(run<BenchPushButton<PushButtonShiftRegister16> >("PushButton<ShiftRegister16>", "stateChanged", sc, CallStateChanged(), ic));
+	}
+	results.push_back(run<BenchPushButton<> >("PushButton", "stateChanged", NOISY, CallStateChanged(), ic));
+	// the scan of a keypad matrix
+	size_t matrixResults = results.size();
+	for (int s = IDLE; s <= REPEATING; s++)
+	{
+		results.push_back(matrixRun<4>((Scenario)s, ic));
+		results.push_back(matrixRun<8>((Scenario)s, ic));
+	}
+	// the robustness of the debounce policies
+	std::vector<NoiseResult> noise;
+	noise.push_back(noiseRun<BenchPushButton<> >("TimeWindow"));
+	noise.push_back(noiseRun<BenchPushButton<PushButtonIntegrator> >("Integrator"));
+	noise.push_back(noiseRun<BenchPushButton<PushButtonShiftRegister8> >("ShiftRegister8"));
+	noise.push_back(noiseRun<BenchPushButton<PushButtonShiftRegister16> >("ShiftRegister16"));
+
+	printf("%d calls per simulated ms, %lu simulated ms per case\n", callsPerMs, benchDuration);
+	printf("%-52s %10s %12s %14s %8s\n", "case", "ns/call", "calls/ms", "instr/call", "events");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result &r = results[i];
+		char instr[32];
+		if (r.instructionsPerCall >= 0)
+			snprintf(instr, sizeof(instr), "%.1f", r.instructionsPerCall);
+		else
+			snprintf(instr, sizeof(instr), "n/a");
+		printf("%-52s %10.2f %12.0f %14s %8lu\n", r.name.c_str(), r.nsPerCall, 1e6 / r.nsPerCall, instr, r.events);
+	}
+
+	printf("\nkeypad matrix scan cost per key\n");
+	for (size_t i = matrixResults; i < results.size(); i++)
+	{
+		const Result &r = results[i];
+		unsigned int keys = r.name.find("<4x4>") != std::string::npos ? 16 : 64;
+		char instr[32];
+		if (r.instructionsPerCall >= 0)
+			snprintf(instr, sizeof(instr), "%.1f", r.instructionsPerCall / keys);
+		else
+			snprintf(instr, sizeof(instr), "n/a");
+		printf("%-52s %10.2f %12s %14s\n", r.name.c_str(), r.nsPerCall / keys, "", instr);
+	}
+
+	printf("\ndebounce policies on the noisy waveform (a 1ms spike every %lu ms on average)\n", noiseSpacing);
+	printf("%-20s %8s %9s %8s %8s %16s %17s\n", "policy", "presses", "reported", "false", "missed", "mean latency ms", "worst latency ms");
+	for (size_t i = 0; i < noise.size(); i++)
+	{
+		const NoiseResult &n = noise[i];
+		unsigned long matched = n.presses - n.missed;
+		printf("%-20s %8lu %9lu %8lu %8lu %16.1f %17lu\n", n.name.c_str(), n.presses, n.reported, n.falsePresses, n.missed,
+			matched ? (double)n.totalLatency / matched : 0.0, n.worstLatency);
+	}
+
+	if (saveFile)
+	{
+		FILE *f = fopen(saveFile, "w");
+		if (!f)
+		{
+			fprintf(stderr, "cannot write %s\n", saveFile);
+			return 2;
+		}
+		for (size_t i = 0; i < results.size(); i++)
+			fprintf(f, "%s %.2f %.1f %lu\n", results[i].name.c_str(), results[i].nsPerCall, results[i].instructionsPerCall, results[i].events);
+		fclose(f);
+	}
+
+	int failed = 0;
+	if (compareFile)
+	{
+		FILE *f = fopen(compareFile, "r");
+		if (!f)
+		{
+			fprintf(stderr, "cannot read %s\n", compareFile);
+			return 2;
+		}
+		std::map<std::string, Result> baseline;
+		Result recorded;
+		char name[128];
+		while (fscanf(f, "%127s %lf %lf %lu", name, &recorded.nsPerCall, &recorded.instructionsPerCall, &recorded.events) == 4)
+			baseline[name] = recorded;
+		fclose(f);
+		unsigned int compared = 0;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const Result &r = results[i];
+			std::map<std::string, Result>::const_iterator b = baseline.find(r.name);
+			if (b == baseline.end())
+				continue;
+			compared++;
+			// the instruction counts when both runs have them, the times otherwise
+			if (b->second.instructionsPerCall >= 0 && r.instructionsPerCall >= 0)
+			{
+				if (r.instructionsPerCall > b->second.instructionsPerCall * (1.0 + tolerance / 100.0))
+				{
+					printf("REGRESSION %s: %.1f instr/call (baseline %.1f)\n", r.name.c_str(), r.instructionsPerCall, b->second.instructionsPerCall);
+					failed = 1;
+				}
+			}
+			else if (r.nsPerCall > b->second.nsPerCall * (1.0 + tolerance / 100.0))
+			{
+				printf("REGRESSION %s: %.2f ns/call (baseline %.2f)\n", r.name.c_str(), r.nsPerCall, b->second.nsPerCall);
+				failed = 1;
+			}
+		}
+		if (!compared)
+		{
+			fprintf(stderr, "no metric to compare - no case of this run is recorded in %s\n", compareFile);
+			return 2;
+		}
+	}
+	return failed;
+}
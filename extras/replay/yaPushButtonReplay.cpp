@@ -0,0 +1,543 @@
+// yaPushButtonReplay.cpp
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// host trace replay - runs the button classes against recorded and synthetic bounce / hold traces
+// for a sweep of debounce, repeat and acceleration parameters, advancing the virtual clock from event
+// to event (the next edge of the trace or the time given by nextEventIn()) instead of tick by tick,
+// with the sweep spread over all the cores
+// the golden file has a line per class and parameter set - the number of callbacks and a hash of
+// their timestamps over all the traces, so a change in behaviour shows as a changed line
+// (c) yaPushButton contributors, 2026
+//
+// Build (from this folder):
+//   g++ -O2 -std=gnu++11 -pthread -I../../src yaPushButtonReplay.cpp -o yaPushButtonReplay
+// Run:
+//   ./yaPushButtonReplay [--traces N] [--trace FILE] [--threads N] [--save FILE] [--compare FILE] [--dump CASE] [--verify N]
+// --traces the number of synthetic traces (default 1000), --trace adds the traces recorded in FILE
+// (lines "time level" in milliseconds, LOW = 0 pressed, a blank line starts the next trace)
+// --save writes the golden file, --compare fails (exit code 1) if any case differs from FILE
+// --dump prints the callback timestamps of the CASE (as named in the golden file) for each trace
+// --verify replays the first N traces of every case tick by tick as well and fails if the results differ
+
+#include <yaPushButtonHost.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+const byte PB_PIN = 2;
+
+/// <summary> A trace - the level changes of the pin and the time the replay ends </summary>
+struct Trace
+{
+	std::vector<PushButtonHostEdge> edges;
+	unsigned long end;
+};
+
+/// <summary> Hardware access policy replaying a trace - the virtual clock and the trace are per thread </summary>
+class ReplayHAL
+{
+	struct State
+	{
+		const Trace *trace;
+		size_t position;
+		unsigned long clock;
+		byte level;
+	};
+
+	static State &state()
+	{
+		static thread_local State s;
+		return s;
+	}
+
+public:
+	typedef unsigned long time_type;
+
+	static time_type now()
+	{
+		return state().clock;
+	}
+	static constexpr time_type toTicks(unsigned long ms)
+	{
+		return ms;
+	}
+	static constexpr unsigned long toMillis(time_type ticks)
+	{
+		return ticks;
+	}
+	static int readPin(byte)
+	{
+		State &s = state();
+		while (s.position < s.trace->edges.size() && s.trace->edges[s.position].time <= s.clock)
+			s.level = s.trace->edges[s.position++].level;
+		return s.level;
+	}
+	static void setupPin(byte, byte)
+	{ }
+	static void idle()
+	{
+		state().clock++;
+	}
+
+	/// <summary> Starts replaying the trace from time 0 (the pin idles HIGH - released) </summary>
+	static void start(const Trace &trace)
+	{
+		State &s = state();
+		s.trace = &trace;
+		s.position = 0;
+		s.clock = 0;
+		s.level = HIGH;
+	}
+
+	static void setTime(unsigned long t)
+	{
+		state().clock = t;
+	}
+};
+
+/// <summary> Pseudo random numbers - the same traces on every run and platform </summary>
+struct Random
+{
+	uint32_t seed;
+	uint32_t next(uint32_t range)
+	{
+		seed = seed * 1103515245UL + 12345UL;
+		return ((seed >> 8) & 0xFFFFFF) % range;
+	}
+};
+
+/// <summary> Appends a bouncing transition to the level at time t </summary>
+/// <returns> the time the level has settled </returns>
+static unsigned long bounce(Trace &trace, Random &rnd, unsigned long t, byte level)
+{
+	PushButtonHostEdge e;
+	unsigned int bounces = rnd.next(5);
+	for (unsigned int i = 0; i < bounces; i++)
+	{
+		e.time = t; e.level = level; trace.edges.push_back(e);
+		t += 1 + rnd.next(2);
+		e.time = t; e.level = level == LOW ? HIGH : LOW; trace.edges.push_back(e);
+		t += 1 + rnd.next(3);
+	}
+	e.time = t; e.level = level; trace.edges.push_back(e);
+	return t;
+}
+
+/// <summary> Builds the synthetic trace i - up to 6 presses with bounce, short to very long holds and noise spikes </summary>
+static Trace synthetic(unsigned int i)
+{
+	static const unsigned long holds[] = { 15, 40, 120, 350, 700, 1500, 3200, 7000 };
+	Random rnd = { (uint32_t)(2654435761UL * (i + 1)) };
+	Trace trace;
+	unsigned long t = 5 + rnd.next(100);
+	unsigned int presses = 1 + rnd.next(6);
+	for (unsigned int p = 0; p < presses; p++)
+	{
+		t = bounce(trace, rnd, t, LOW);
+		unsigned long hold = holds[rnd.next(sizeof(holds) / sizeof(holds[0]))];
+		t += hold + rnd.next(hold / 4 + 1);
+		t = bounce(trace, rnd, t, HIGH);
+		t += 10 + rnd.next(800);
+		if (!rnd.next(8)) // a 1ms noise spike while released
+		{
+			PushButtonHostEdge e = { t, LOW };
+			trace.edges.push_back(e);
+			e.time = t + 1; e.level = HIGH;
+			trace.edges.push_back(e);
+			t += 2 + rnd.next(200);
+		}
+	}
+	trace.end = t + 1000;
+	return trace;
+}
+
+/// <summary> Reads the traces recorded in a file </summary>
+static bool loadTraces(const char *fileName, std::vector<Trace> &traces)
+{
+	FILE *f = fopen(fileName, "r");
+	if (!f)
+		return false;
+	Trace trace;
+	char line[128];
+	bool more = true;
+	while (more)
+	{
+		more = fgets(line, sizeof(line), f) != NULL;
+		unsigned long time;
+		int level;
+		if (more && line[0] == '#')
+			continue;
+		if (more && sscanf(line, "%lu %d", &time, &level) == 2)
+		{
+			PushButtonHostEdge e = { time, (byte)(level ? HIGH : LOW) };
+			trace.edges.push_back(e);
+		}
+		else if (!trace.edges.empty()) // a blank line or the end of the file
+		{
+			trace.end = trace.edges.back().time + 1000;
+			traces.push_back(trace);
+			trace.edges.clear();
+		}
+	}
+	fclose(f);
+	return true;
+}
+
+/// <summary> The button classes replayed </summary>
+enum ClassId { PLAIN, AUTOREPEAT, TWOSPEED, ACCELERATED };
+static const char *className[] = { "PushButton", "PushButtonAutoRepeat", "PushButton2SpeedAutoRepeat", "PushButtonAutoAcceleratedRepeat" };
+
+/// <summary> A class and a parameter set </summary>
+struct Case
+{
+	byte classId;
+	unsigned long debounce, repeatDelay, repeatPeriod, acc1, acc2, acc3;
+	std::string name;
+};
+
+/// <summary> The callbacks of a case - counted and hashed (FNV-1a), kept only for --dump </summary>
+struct Sink
+{
+	unsigned long events;
+	unsigned long long calls;
+	uint64_t hash;
+	std::vector<std::string> *dump;
+	std::string line;
+
+	Sink() : events(0), calls(0), hash(14695981039346656037ULL), dump(NULL)
+	{ }
+
+	void mix(unsigned long v)
+	{
+		for (int i = 0; i < 4; i++, v >>= 8)
+		{
+			hash ^= v & 0xFF;
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	/// <summary> Records a callback - the time and the code of the event </summary>
+	void record(unsigned int trace, unsigned long t, unsigned int code)
+	{
+		events++;
+		mix(trace);
+		mix(t);
+		mix(code);
+		if (dump)
+		{
+			char s[32];
+			snprintf(s, sizeof(s), " %lu:%u", t, code);
+			line += s;
+		}
+	}
+
+	void endTrace(unsigned int trace)
+	{
+		if (dump)
+		{
+			char s[32];
+			snprintf(s, sizeof(s), "trace %u:", trace);
+			dump->push_back(s + line);
+			line.clear();
+		}
+	}
+};
+
+/// <summary> Services a plain button - the presses (code 1) and the releases (code 2) </summary>
+static void service(PushButton<false, ReplayHAL> &b, unsigned long t, unsigned int trace, Sink &sink)
+{
+	byte r = b.stateChanged(t);
+	if (r != BUTTON_NOCHANGE)
+		sink.record(trace, t, r);
+}
+
+/// <summary> Services an autorepeat button - the keypresses (code 10 + kind, plus 100 * (count - 1)) </summary>
+template < class B >
+static void service(B &b, unsigned long t, unsigned int trace, Sink &sink)
+{
+	b.handle(t, [&](ButtonEvent e) { sink.record(trace, t, 10 + e.kind + 100 * (e.count - 1)); });
+}
+
+/// <summary> Replays a trace - from event to event, or on every tick </summary>
+template < class B >
+static void replay(B &b, const Trace &trace, unsigned int index, Sink &sink, bool tickByTick)
+{
+	ReplayHAL::start(trace);
+	b.init();
+	size_t edge = 0;
+	unsigned long t = 0;
+	while (t < trace.end)
+	{
+		ReplayHAL::setTime(t);
+		service(b, t, index, sink);
+		sink.calls++;
+		if (tickByTick)
+		{
+			t++;
+			continue;
+		}
+		// the next edge of the trace or the next event of the button, whichever comes first
+		while (edge < trace.edges.size() && trace.edges[edge].time <= t)
+			edge++;
+		unsigned long next = edge < trace.edges.size() ? trace.edges[edge].time : trace.end;
+		unsigned long in = b.nextEventIn(t);
+		if (in != B::maxTime() && t + (in ? in : 1) < next)
+			next = t + (in ? in : 1);
+		t = next;
+	}
+	sink.endTrace(index);
+}
+
+/// <summary> Replays all the traces for a case </summary>
+static void runCase(const Case &c, const std::vector<Trace> &traces, size_t count, Sink &sink, bool tickByTick)
+{
+	for (unsigned int i = 0; i < count; i++)
+	{
+		switch (c.classId)
+		{
+		case PLAIN:
+			{
+				PushButton<false, ReplayHAL> b(PB_PIN, c.debounce);
+				replay(b, traces[i], i, sink, tickByTick);
+			}
+			break;
+		case AUTOREPEAT:
+			{
+				PushButtonAutoRepeat<false, ReplayHAL> b(PB_PIN, NULL, c.repeatDelay, c.repeatPeriod, c.debounce);
+				replay(b, traces[i], i, sink, tickByTick);
+			}
+			break;
+		case TWOSPEED:
+			{
+				PushButton2SpeedAutoRepeat<false, ReplayHAL> b(PB_PIN, NULL, c.repeatDelay, c.repeatPeriod, c.acc1, c.acc2, c.debounce);
+				replay(b, traces[i], i, sink, tickByTick);
+			}
+			break;
+		case ACCELERATED:
+			{
+				PushButtonAutoAcceleratedRepeat<false, ReplayHAL> b(PB_PIN, NULL, c.repeatDelay, c.repeatPeriod, c.acc1, c.acc2, c.acc3, c.debounce);
+				replay(b, traces[i], i, sink, tickByTick);
+			}
+			break;
+		}
+	}
+}
+
+/// <summary> Builds the sweep - every class with every combination of the parameters </summary>
+static std::vector<Case> sweep()
+{
+	static const unsigned long debounces[] = { 5, 10, 20, 35, 50, 75, 100 };
+	static const unsigned long repeatDelays[] = { 250, 500, 1000 };
+	static const unsigned long repeatPeriods[] = { 50, 100, 200, 400 };
+	std::vector<Case> cases;
+	char name[160];
+	for (size_t d = 0; d < sizeof(debounces) / sizeof(debounces[0]); d++)
+	{
+		Case c = { PLAIN, debounces[d], 0, 0, 0, 0, 0, "" };
+		snprintf(name, sizeof(name), "%s/d%lu", className[c.classId], c.debounce);
+		c.name = name;
+		cases.push_back(c);
+		for (size_t rd = 0; rd < sizeof(repeatDelays) / sizeof(repeatDelays[0]); rd++)
+			for (size_t rp = 0; rp < sizeof(repeatPeriods) / sizeof(repeatPeriods[0]); rp++)
+			{
+				c.classId = AUTOREPEAT;
+				c.repeatDelay = repeatDelays[rd];
+				c.repeatPeriod = repeatPeriods[rp];
+				c.acc1 = c.acc2 = c.acc3 = 0;
+				snprintf(name, sizeof(name), "%s/d%lu/r%lu/p%lu", className[c.classId], c.debounce, c.repeatDelay, c.repeatPeriod);
+				c.name = name;
+				cases.push_back(c);
+				for (int a = 0; a < 2; a++)
+					for (int p = 0; p < 2; p++)
+					{
+						c.classId = TWOSPEED;
+						c.acc1 = c.repeatDelay + (a ? 2500 : 1000); // accelerate delay
+						c.acc2 = c.repeatPeriod / (p ? 2 : 4); // accelerated period
+						snprintf(name, sizeof(name), "%s/d%lu/r%lu/p%lu/a%lu/q%lu", className[c.classId], c.debounce, c.repeatDelay, c.repeatPeriod, c.acc1, c.acc2);
+						c.name = name;
+						cases.push_back(c);
+					}
+				for (int a = 0; a < 2; a++)
+					for (int s = 0; s < 2; s++)
+						for (int m = 0; m < 2; m++)
+						{
+							c.classId = ACCELERATED;
+							c.acc1 = c.repeatDelay + (a ? 2000 : 500); // accelerate delay
+							c.acc2 = s ? 20 : 5; // acceleration step
+							c.acc3 = m ? 40 : 10; // minimum period
+							snprintf(name, sizeof(name), "%s/d%lu/r%lu/p%lu/a%lu/s%lu/m%lu", className[c.classId], c.debounce, c.repeatDelay, c.repeatPeriod, c.acc1, c.acc2, c.acc3);
+							c.name = name;
+							cases.push_back(c);
+						}
+			}
+	}
+	return cases;
+}
+
+/// <summary> Runs the function for each case on all the threads </summary>
+template < class F >
+static void parallel(size_t cases, unsigned int threads, F f)
+{
+	std::atomic<size_t> nextCase(0);
+	std::vector<std::thread> pool;
+	for (unsigned int i = 0; i < threads; i++)
+		pool.push_back(std::thread([&]()
+		{
+			for (size_t c = nextCase++; c < cases; c = nextCase++)
+				f(c);
+		}));
+	for (size_t i = 0; i < pool.size(); i++)
+		pool[i].join();
+}
+
+int main(int argc, char *argv[])
+{
+	const char *saveFile = NULL, *compareFile = NULL, *dumpCase = NULL;
+	unsigned int syntheticTraces = 1000, threads = std::thread::hardware_concurrency(), verify = 0;
+	std::vector<Trace> traces;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--traces") && i + 1 < argc)
+			syntheticTraces = (unsigned int)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--trace") && i + 1 < argc)
+		{
+			if (!loadTraces(argv[++i], traces))
+			{
+				fprintf(stderr, "cannot read %s\n", argv[i]);
+				return 2;
+			}
+		}
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+			threads = (unsigned int)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--save") && i + 1 < argc)
+			saveFile = argv[++i];
+		else if (!strcmp(argv[i], "--compare") && i + 1 < argc)
+			compareFile = argv[++i];
+		else if (!strcmp(argv[i], "--dump") && i + 1 < argc)
+			dumpCase = argv[++i];
+		else if (!strcmp(argv[i], "--verify") && i + 1 < argc)
+			verify = (unsigned int)atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "usage: %s [--traces N] [--trace FILE] [--threads N] [--save FILE] [--compare FILE] [--dump CASE] [--verify N]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (!threads)
+		threads = 1;
+	for (unsigned int i = 0; i < syntheticTraces; i++)
+		traces.push_back(synthetic(i));
+	if (traces.empty())
+	{
+		fprintf(stderr, "no traces\n");
+		return 2;
+	}
+
+	std::vector<Case> cases = sweep();
+	if (dumpCase)
+	{
+		for (size_t c = 0; c < cases.size(); c++)
+			if (cases[c].name == dumpCase)
+			{
+				std::vector<std::string> lines;
+				Sink sink;
+				sink.dump = &lines;
+				runCase(cases[c], traces, traces.size(), sink, false);
+				for (size_t i = 0; i < lines.size(); i++)
+					printf("%s\n", lines[i].c_str());
+				return 0;
+			}
+		fprintf(stderr, "no case %s\n", dumpCase);
+		return 2;
+	}
+
+	std::vector<Sink> results(cases.size());
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	parallel(cases.size(), threads, [&](size_t c) { runCase(cases[c], traces, traces.size(), results[c], false); });
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	unsigned long long events = 0, calls = 0, ticks = 0;
+	for (size_t c = 0; c < results.size(); c++)
+	{
+		events += results[c].events;
+		calls += results[c].calls;
+	}
+	for (size_t i = 0; i < traces.size(); i++)
+		ticks += traces[i].end;
+	printf("%zu cases x %zu traces = %llu replays on %u threads in %.2f s\n", cases.size(), traces.size(),
+		(unsigned long long)cases.size() * traces.size(), threads, seconds);
+	printf("%llu callbacks, %llu calls (%.1f%% of the %llu ticks)\n", events, calls, 100.0 * calls / (ticks * cases.size()), ticks * cases.size());
+
+	int failed = 0;
+	if (verify)
+	{
+		size_t n = verify < traces.size() ? verify : traces.size();
+		std::vector<Sink> event(cases.size()), tick(cases.size());
+		parallel(cases.size(), threads, [&](size_t c)
+		{
+			runCase(cases[c], traces, n, event[c], false);
+			runCase(cases[c], traces, n, tick[c], true);
+		});
+		unsigned int differ = 0;
+		for (size_t c = 0; c < cases.size(); c++)
+			if (event[c].hash != tick[c].hash || event[c].events != tick[c].events)
+			{
+				if (differ++ < 10)
+					printf("EVENT/TICK MISMATCH %s: %lu callbacks (tick by tick %lu)\n", cases[c].name.c_str(), event[c].events, tick[c].events);
+				failed = 1;
+			}
+		printf("verified %zu traces of each case tick by tick: %u cases differ\n", n, differ);
+	}
+
+	if (compareFile)
+	{
+		FILE *f = fopen(compareFile, "r");
+		if (!f)
+		{
+			fprintf(stderr, "cannot read %s\n", compareFile);
+			return 2;
+		}
+		std::map<std::string, std::pair<unsigned long, std::string> > golden;
+		char name[160], hash[32];
+		unsigned long n;
+		while (fscanf(f, "%159s %lu %31s", name, &n, hash) == 3)
+			golden[name] = std::make_pair(n, std::string(hash));
+		fclose(f);
+		unsigned int differ = 0;
+		for (size_t c = 0; c < cases.size(); c++)
+		{
+			char h[32];
+			snprintf(h, sizeof(h), "%016llx", (unsigned long long)results[c].hash);
+			std::map<std::string, std::pair<unsigned long, std::string> >::const_iterator g = golden.find(cases[c].name);
+			if (g == golden.end())
+				continue;
+			if (g->second.first != results[c].events || g->second.second != h)
+			{
+				if (differ++ < 10)
+					printf("CHANGED %s: %lu callbacks (golden %lu)\n", cases[c].name.c_str(), results[c].events, g->second.first);
+				failed = 1;
+			}
+		}
+		printf("compared with %s: %u cases changed\n", compareFile, differ);
+	}
+
+	if (saveFile)
+	{
+		FILE *f = fopen(saveFile, "w");
+		if (!f)
+		{
+			fprintf(stderr, "cannot write %s\n", saveFile);
+			return 2;
+		}
+		for (size_t c = 0; c < cases.size(); c++)
+			fprintf(f, "%s %lu %016llx\n", cases[c].name.c_str(), results[c].events, (unsigned long long)results[c].hash);
+		fclose(f);
+	}
+	return failed;
+}
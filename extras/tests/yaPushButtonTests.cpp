@@ -0,0 +1,957 @@
+// yaPushButtonTests.cpp
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// host tests of the behaviour that is hard to check on the target - the button classes
+// are driven on the simulated clock and pins of yaPushButtonHost.h
+// (c) yaPushButton contributors, 2026
+//
+// Build (from this folder):
+//   g++ -O2 -std=gnu++11 -I../../src yaPushButtonTests.cpp -o yaPushButtonTests
+// Run:
+//   ./yaPushButtonTests
+// prints the failed checks, the exit code is 1 if any check failed
+
+#define YAPUSHBUTTON_ADAPTIVE_DEBOUNCE // for testAdaptiveDebounce, off for the buttons that do not call setAdaptiveDebounce()
+#include <yaPushButtonHost.h>
+#include <yaPushButtonEventQueue.h>
+#include <yaPushButtonInterrupt.h>
+#include <yaPushButtonBank.h>
+#include <yaPushButtonLadder.h>
+#include <yaPushButtonGroup.h>
+#include <yaPushButtonMatrix.h>
+#include <yaPushButtonDebounce.h>
+#include <yaPushButtonBulk.h>
+#include <yaPushButtonGestures.h>
+#include <yaPushButtonStatic.h>
+#include <yaPushButtonCurve.h>
+
+#include <cstdio>
+#include <vector>
+
+typedef PushButtonHostHAL Sim;
+
+const byte PB_PIN = 2;
+
+static unsigned int checks = 0;
+static unsigned int failures = 0;
+
+#define CHECK(c) do { checks++; if (!(c)) { failures++; printf("%s:%d: failed: %s\n", __FILE__, __LINE__, #c); } } while (0)
+
+/// <summary> Counts the keypresses reported to it </summary>
+struct KeyCounter
+{
+	unsigned int events;
+	unsigned int keypresses;
+	void operator()(ButtonEvent e)
+	{
+		events++;
+		keypresses += e.count;
+	}
+};
+
+// the keypresses coalesced by BUTTON_CATCHUP_COUNT reach the consumer of the queue with their number
+static void testQueueCatchUpCount()
+{
+	Sim::reset();
+	PushButtonAutoRepeat<false, Sim> counted(PB_PIN, NULL, 500, 100, 20);
+	PushButtonAutoRepeat<false, Sim> burst(PB_PIN, NULL, 500, 100, 20);
+	PushButtonAutoRepeat<false, Sim> polled(PB_PIN, NULL, 500, 100, 20);
+	counted.setCatchUp(BUTTON_CATCHUP_COUNT);
+	burst.setCatchUp(BUTTON_CATCHUP_BURST);
+	counted.init();
+	burst.init();
+	polled.init();
+	PushButtonEventQueue<16, 8, Sim> queue;
+	KeyCounter burstKeys = { 0, 0 }, polledKeys = { 0, 0 };
+
+	Sim::setPin(PB_PIN, LOW);
+	for (unsigned long t = 0; t <= 2000; t++)
+	{
+		if (t <= 100 || t == 2000) // the loop stalls from 100 to 2000 ms
+		{
+			queue.handle(0, counted, t);
+			burst.handle(t, burstKeys);
+		}
+		polled.handle(t, polledKeys); // on every tick
+	}
+
+	PushButtonEventQueue<16, 8, Sim>::Event e;
+	unsigned int events = 0, keypresses = 0;
+	while (queue.pop(e))
+	{
+		CHECK(e.id == 0);
+		CHECK(e.count >= 1);
+		if (e.type == BUTTON_QUEUED_KEYPRESS)
+			CHECK(e.count == 1);
+		events++;
+		keypresses += e.count;
+	}
+	CHECK(events == 2); // the first keypress and the coalesced repeats
+	CHECK(polledKeys.keypresses > 10);
+	CHECK(keypresses == polledKeys.keypresses);
+	CHECK(burstKeys.keypresses == polledKeys.keypresses);
+	CHECK(queue.dropped() == 0);
+}
+
+// the presses and releases are queued with the time of their edges, not the time the debouncing reported them
+static void testQueueEdgeTimes()
+{
+	Sim::reset();
+	PushButton<false, Sim> plain(PB_PIN, 20);
+	PushButtonAutoRepeat<false, Sim> repeating(PB_PIN, NULL, 500, 100, 20);
+	plain.init();
+	repeating.init();
+	PushButtonEventQueue<16, 8, Sim> queue;
+	for (unsigned long t = 0; t < 1000; t++)
+	{
+		Sim::setTime(t);
+		Sim::setPin(PB_PIN, t >= 10 && t < 700 ? LOW : HIGH);
+		queue.poll(0, plain, t);
+		queue.handle(1, repeating, t);
+	}
+
+	PushButtonEventQueue<16, 8, Sim>::Event e;
+	unsigned int repeats = 0;
+	while (queue.pop(e))
+	{
+		if (e.type == BUTTON_QUEUED_PRESSED || e.type == BUTTON_QUEUED_KEYPRESS)
+			CHECK(e.time == 10 && e.held == 0);
+		else if (e.type == BUTTON_QUEUED_RELEASED)
+			CHECK(e.time == 700 && e.held == 690);
+		else if (e.type == BUTTON_QUEUED_REPEAT)
+		{
+			CHECK(e.held == e.time - 10);
+			repeats++;
+		}
+	}
+	CHECK(repeats == 2); // at 531 and 631 - the schedule starts when the press was reported
+	CHECK(queue.dropped() == 0);
+}
+
+/// <summary> Logs the time (of the simulated clock) and the contents of the events reported to it </summary>
+struct EventLog
+{
+	std::vector<unsigned long> *log;
+	void operator()(ButtonEvent e) const
+	{
+		log->push_back(Sim::now());
+		log->push_back(e.kind);
+		log->push_back(e.repeatIndex);
+		log->push_back(e.count);
+	}
+};
+
+// presses across the rollovers of a 16-bit millisecond counter (at 65536, 131072 and 196608), 
+// with bounce, a short press, a 40 s hold and a 75 s hold longer than the range of the counter
+static const PushButtonHostEdge wrapPresses[] =
+{
+	{ 63000, LOW }, { 63001, HIGH }, { 63003, LOW }, { 66500, HIGH }, { 66502, LOW }, { 66504, HIGH },
+	{ 67000, LOW }, { 67300, HIGH },
+	{ 70000, LOW }, { 110000, HIGH },
+	{ 130000, LOW }, { 130002, HIGH }, { 130004, LOW }, { 133000, HIGH },
+	{ 140000, LOW }, { 215000, HIGH }
+};
+
+/// <summary> Runs the same button with 32-bit and with 16-bit time across the counter rollover, 
+/// calling handle() every step ms, and checks that they report the same events at the same times </summary>
+template < class B32, class B16 >
+static void compareAcrossWrap(B32 &b32, B16 &b16, unsigned long step)
+{
+	std::vector<unsigned long> log32, log16;
+	EventLog f32 = { &log32 }, f16 = { &log16 };
+	Sim::reset();
+	Sim::setWaveform(PB_PIN, wrapPresses, sizeof(wrapPresses) / sizeof(wrapPresses[0]));
+	b32.init();
+	b16.init();
+	for (unsigned long t = 60000; t <= 220000; t += step)
+	{
+		Sim::setTime(t);
+		b32.handle(B32::hal_type::now(), f32);
+		b16.handle(B16::hal_type::now(), f16);
+	}
+	CHECK(log32.size() > 4 * 100);
+	CHECK(log32 == log16);
+}
+
+// the 16-bit tick counter gives the same events as the 32-bit millisecond time across its rollover
+static void testRollover()
+{
+	typedef PushButtonTicksHAL<uint16_t, 0, Sim> Sim16;
+	for (unsigned long step = 1; step <= 13; step += 12) // on every tick and late calls (catch-up)
+	{
+		PushButtonAutoRepeat<false, Sim> r32(PB_PIN, NULL, 500, 100, 20);
+		PushButtonAutoRepeat<false, Sim16> r16(PB_PIN, NULL, 500, 100, 20);
+		r32.setCatchUp(BUTTON_CATCHUP_BURST);
+		r16.setCatchUp(BUTTON_CATCHUP_BURST);
+		compareAcrossWrap(r32, r16, step);
+
+		PushButton2SpeedAutoRepeat<false, Sim> s32(PB_PIN, NULL, 500, 200, 2000, 50, 20);
+		PushButton2SpeedAutoRepeat<false, Sim16> s16(PB_PIN, NULL, 500, 200, 2000, 50, 20);
+		s32.setCatchUp(BUTTON_CATCHUP_COUNT);
+		s16.setCatchUp(BUTTON_CATCHUP_COUNT);
+		compareAcrossWrap(s32, s16, step);
+
+		PushButtonAutoAcceleratedRepeat<false, Sim> a32(PB_PIN, NULL, 500, 200, 2000, 10, 20, 20);
+		PushButtonAutoAcceleratedRepeat<false, Sim16> a16(PB_PIN, NULL, 500, 200, 2000, 10, 20, 20);
+		compareAcrossWrap(a32, a16, step);
+	}
+}
+
+// the longest delays that fit into the compact time types, 8-bit ticks long enough for the default delays
+static void testDelayRange()
+{
+	CHECK((PushButton<false, PushButtonTicksHAL<uint16_t, 0, Sim> >::maxDelay() == 32766));
+	CHECK((PushButton<false, PushButtonTicksHAL<uint8_t, 0, Sim> >::maxDelay() == 126));
+	CHECK((PushButton<false, PushButtonTicksHAL<uint8_t, 3, Sim> >::maxDelay() == 1008));
+
+	// a 3 s hold with the default 500 / 200 ms autorepeat on 8 ms ticks - the keypresses of millisecond time
+	PushButtonAutoRepeat<false, Sim> ms(PB_PIN);
+	typedef PushButtonTicksHAL<uint8_t, 3, Sim> Sim8;
+	PushButtonAutoRepeat<false, Sim8> ticks(PB_PIN);
+	KeyCounter msKeys = { 0, 0 }, ticksKeys = { 0, 0 };
+	Sim::reset();
+	ms.init();
+	ticks.init();
+	Sim::setPin(PB_PIN, LOW);
+	for (unsigned long t = 0; t < 3000; t++)
+	{
+		Sim::setTime(t);
+		ms.handle(t, msKeys);
+		ticks.handle(Sim8::now(), ticksKeys);
+	}
+	CHECK(msKeys.keypresses == 14); // the press and the repeats at 500, 700, ... 2900 ms
+	CHECK(ticksKeys.keypresses + 1 >= msKeys.keypresses && ticksKeys.keypresses <= msKeys.keypresses + 1);
+}
+
+/// <summary> The time a press is reported with a debounce delay shorter than the samples of the policy </summary>
+/// <remarks> the button is polled many times per tick - the samples have to stay a tick apart </remarks>
+template < template < typename > class DEBOUNCER >
+static unsigned long shortDebouncePress(unsigned long debounceDelay)
+{
+	PushButton<false, Sim, DEBOUNCER> b(PB_PIN, debounceDelay);
+	Sim::reset();
+	b.init();
+	Sim::setPin(PB_PIN, LOW);
+	for (unsigned long t = 0; t < 100; t++)
+	{
+		Sim::setTime(t);
+		for (int i = 0; i < 50; i++)
+			if (b.stateChanged() == BUTTON_PRESSED)
+				return t;
+	}
+	return 0;
+}
+
+static void testShortDebounce()
+{
+	CHECK(shortDebouncePress<PushButtonIntegrator>(2) == 7); // 7 samples a tick apart after the edge
+	CHECK(shortDebouncePress<PushButtonIntegrator>(0) == 7);
+	CHECK(shortDebouncePress<PushButtonShiftRegister8>(3) == 7);
+	CHECK(shortDebouncePress<PushButtonShiftRegister16>(10) == 15);
+	CHECK(shortDebouncePress<PushButtonIntegrator>(70) == 70); // long enough - a sample every 10 ticks
+}
+
+/// <summary> Runs a PushButton through the waveform until the time given, polling every millisecond </summary>
+template < class B >
+static void pollUntil(B &b, unsigned long &t, unsigned long until)
+{
+	for (; t < until; t++)
+	{
+		Sim::setTime(t);
+		b.stateChanged(t);
+	}
+}
+
+// the adaptive debounce widens at once on a longer bounce, shrinks slowly on clean presses
+// and releases and stays within the bounds
+static void testAdaptiveDebounce()
+{
+	// a press bouncing for 45 ms, 20 clean releases and presses, then a press bouncing for 3 ms
+	std::vector<PushButtonHostEdge> w;
+	PushButtonHostEdge bouncy[] = { { 10, LOW }, { 20, HIGH }, { 30, LOW }, { 40, HIGH }, { 55, LOW } };
+	w.insert(w.end(), bouncy, bouncy + 5);
+	for (unsigned long i = 1; i <= 20; i++)
+	{
+		PushButtonHostEdge release = { 200 * i, HIGH }, press = { 200 * i + 100, LOW };
+		w.push_back(release);
+		w.push_back(press);
+	}
+	PushButtonHostEdge shortBounce[] = { { 5000, HIGH }, { 5100, LOW }, { 5101, HIGH }, { 5103, LOW } };
+	w.insert(w.end(), shortBounce, shortBounce + 4);
+
+	Sim::reset();
+	Sim::setWaveform(PB_PIN, &w[0], (unsigned int)w.size());
+	PushButton<false, Sim> b(PB_PIN, 20);
+	b.init();
+	b.setAdaptiveDebounce(4, 60);
+	CHECK(b.getDebounceDelay() == 60); // starts at the upper bound
+	unsigned long t = 0;
+	pollUntil(b, t, 150);
+	CHECK(b.isDown() && b.getBounceEdges() == 4 && b.getSettleTime() == 45);
+	CHECK(b.getLearnedSettleTime() == 45 && b.getDebounceDelay() == 60); // 90 clamped to the upper bound
+	pollUntil(b, t, 300); // the first clean release
+	CHECK(b.getBounceEdges() == 0 && b.getLearnedSettleTime() == 39 && b.getDebounceDelay() == 60);
+	unsigned long previous = b.getDebounceDelay();
+	bool shrinking = true;
+	for (unsigned long until = 400; until < 5000; until += 100)
+	{
+		pollUntil(b, t, until);
+		shrinking = shrinking && b.getDebounceDelay() <= previous;
+		previous = b.getDebounceDelay();
+	}
+	CHECK(shrinking && b.getLearnedSettleTime() == 0 && b.getDebounceDelay() == 4); // clamped to the lower bound
+	pollUntil(b, t, 5200);
+	CHECK(b.isDown() && b.getBounceEdges() == 2 && b.getSettleTime() == 3);
+	CHECK(b.getLearnedSettleTime() == 3 && b.getDebounceDelay() == 6); // widened at once
+}
+
+/// <summary> PushButtonInterrupt with the edges waiting in its buffer visible </summary>
+template < byte N >
+struct InterruptProbe : public PushButtonInterrupt<false, Sim, N>
+{
+	InterruptProbe(byte pbPin, unsigned long DebounceDelay) : PushButtonInterrupt<false, Sim, N>(pbPin, DebounceDelay) { }
+	byte edgesWaiting() const { return this->edges.count(); }
+};
+
+// a full buffer drops the newest elements - the ones already in keep their order,
+// the interrupt capture reports the edges kept in order and then re-reads the pin
+static void testOverflow()
+{
+	PushButtonRingBuffer<int, 8> rb;
+	unsigned int dropped = 0;
+	for (int i = 0; i < 12; i++)
+		if (!rb.push(i))
+			dropped++;
+	CHECK(dropped == 12u - rb.capacity());
+	CHECK(rb.count() == rb.capacity());
+	int v;
+	for (int i = 0; i < rb.capacity(); i++)
+		CHECK(rb.pop(v) && v == i);
+	CHECK(rb.empty() && !rb.pop(v));
+	CHECK(rb.push(100) && rb.pop(v) && v == 100); // usable again after the overflow
+
+	// press / release every 100 ms, 6 edges into room for 3 - the last 3 are dropped, the button ends up released
+	Sim::reset();
+	InterruptProbe<4> b(PB_PIN, 20);
+	b.init();
+	for (unsigned long i = 0; i < 6; i++)
+	{
+		Sim::setTime(100 * i);
+		Sim::setPin(PB_PIN, i % 2 ? HIGH : LOW);
+		b.captureEdge();
+	}
+	CHECK(b.edgesWaiting() == 3 && b.pending());
+	std::vector<byte> changes;
+	std::vector<unsigned long> times;
+	for (unsigned long t = 1000; t < 1100; t++)
+	{
+		Sim::setTime(t);
+		for (byte c; (c = b.stateChanged(t)) != BUTTON_NOCHANGE; )
+		{
+			changes.push_back(c);
+			times.push_back(t);
+		}
+	}
+	// the 3 edges kept (at 0, 100 and 200 ms) in order, then the release read from the pin after the overflow
+	CHECK(changes.size() == 4 && changes[0] == BUTTON_PRESSED && changes[1] == BUTTON_RELEASED && changes[2] == BUTTON_PRESSED && changes[3] == BUTTON_RELEASED);
+	CHECK(times.size() == 4 && times[0] == 1000 && times[1] == 1000 && times[2] == 1000 && times[3] == 1021);
+	CHECK(!b.pending() && !b.isPressed());
+}
+
+// the port of the bank (active low - a bit reads 0 while its button is pressed)
+static byte bankPort;
+static byte readBankPort()
+{
+	return bankPort;
+}
+
+// one bouncing bit among steady ones - its vertical counter keeps being reset without disturbing
+// the others, the change is taken after 4 samples in a row differ from the debounced state
+static void testBankBounce()
+{
+	Sim::reset();
+	PushButtonBank<byte, Sim> bank(readBankPort, 0, 5);
+	std::vector<unsigned long> times;
+	std::vector<byte> pressed, released;
+	for (unsigned long t = 0; t <= 300; t++)
+	{
+		Sim::setTime(t);
+		// buttons 0 and 2 pressed at 0 ms, button 5 pressed on 3 samples out of 4 until 100 ms, then held, all released at 200 ms
+		bool bouncing = t <= 100 ? (t / 5) % 4 != 0 : true;
+		byte down = t < 200 ? (byte)(0x05 | (bouncing ? 0x20 : 0)) : 0;
+		bankPort = (byte)~down;
+		if (bank.scan(t))
+		{
+			times.push_back(t);
+			pressed.push_back(bank.pressed());
+			released.push_back(bank.released());
+		}
+	}
+	CHECK(times.size() == 3);
+	CHECK(times.size() == 3 && times[0] == 20 && pressed[0] == 0x05 && released[0] == 0); // the 4th sample
+	CHECK(times.size() == 3 && times[1] == 120 && pressed[1] == 0x20 && released[1] == 0); // 4 samples after the bouncing stopped
+	CHECK(times.size() == 3 && times[2] == 215 && pressed[2] == 0 && released[2] == 0x25); // sampled at 200 - 215 ms
+	CHECK(bank.state() == 0 && bank.nextEventIn(300) == (Sim::time_type)~(Sim::time_type)0);
+}
+
+/// <summary> Checks the classification on both sides of each threshold of a ladder </summary>
+/// <remarks> the level just below a threshold is the button below it, the threshold itself the next one (or none) </remarks>
+template < class L >
+static void checkLadderThresholds(const uint16_t *thresholds, uint16_t idle)
+{
+	CHECK(L::classify(0) == 0);
+	for (byte i = 0; i < L::buttons; i++)
+	{
+		CHECK(L::classify(thresholds[i] - 1) == i);
+		CHECK(L::classify(thresholds[i]) == i + 1);
+	}
+	CHECK(L::classify(idle) == L::buttons);
+	CHECK(L::classify(0xFFFF) == L::buttons);
+}
+
+// the ADC level is classified into the button pressed at the midpoints between the levels
+static void testLadder()
+{
+	// the five buttons of the common LCD keypad shield
+	typedef PushButtonLadderHAL<PushButtonLadderLevels<1023, 0, 144, 329, 504, 741>, 0, Sim> Shield;
+	const uint16_t shield[] = { 72, 237, 417, 623, 882 };
+	checkLadderThresholds<Shield>(shield, 1023);
+	// an even number of buttons, a single one
+	typedef PushButtonLadderHAL<PushButtonLadderLevels<1000, 100, 300, 500, 700>, 1, Sim> Four;
+	const uint16_t four[] = { 200, 400, 600, 850 };
+	checkLadderThresholds<Four>(four, 1000);
+	typedef PushButtonLadderHAL<PushButtonLadderLevels<1023, 0>, 2, Sim> One;
+	const uint16_t one[] = { 512 };
+	checkLadderThresholds<One>(one, 1023);
+
+	// read through update() - the button pressed reads LOW, the others and the idle level HIGH
+	Sim::reset();
+	Sim::setAnalog(0, 1023);
+	Shield::update();
+	CHECK(Shield::pressed() == Shield::buttons && Shield::level() == 1023);
+	CHECK(Shield::readPin(0) == HIGH && Shield::readPin(4) == HIGH);
+	Sim::setAnalog(0, 330);
+	Shield::update();
+	CHECK(Shield::pressed() == 2 && Shield::readPin(2) == LOW && Shield::readPin(1) == HIGH && Shield::readPin(3) == HIGH);
+}
+
+/// <summary> PushButton counting how many times the group services it and reads its pin </summary>
+struct CountedButton : public PushButton<false, Sim>
+{
+	unsigned int serviced, reads;
+	CountedButton(byte pbPin) : PushButton<false, Sim>(pbPin, 20), serviced(0), reads(0) { }
+	byte stateChanged(time_type now)
+	{
+		serviced++;
+		return PushButton<false, Sim>::stateChanged(now);
+	}
+	bool isPressed()
+	{
+		reads++;
+		return PushButton<false, Sim>::isPressed();
+	}
+};
+
+// the group services only the active buttons - an idle one costs a pin read until it is pressed,
+// and drops out again once it is released and debounced
+static void testGroupSkip()
+{
+	Sim::reset();
+	CountedButton b0(5), b1(6), b2(7);
+	ButtonGroup<CountedButton, CountedButton, CountedButton> group(b0, b1, b2);
+	group.init();
+	CHECK(group.activity() == 0);
+	std::vector<unsigned long> pressedAt, releasedAt;
+	unsigned int activeScans = 0;
+	bool onlyPressed = true; // no other button turns active
+	for (unsigned long t = 1; t <= 300; t++)
+	{
+		Sim::setTime(t);
+		Sim::setPin(6, t >= 100 && t < 200 ? LOW : HIGH);
+		if (group.update(t))
+		{
+			if (group.stateChanged(1) == BUTTON_PRESSED)
+				pressedAt.push_back(t);
+			if (group.stateChanged(1) == BUTTON_RELEASED)
+				releasedAt.push_back(t);
+		}
+		if (group.activity())
+			activeScans++;
+		onlyPressed = onlyPressed && (group.activity() & ~2) == 0;
+	}
+	CHECK(onlyPressed);
+	CHECK(b0.serviced == 0 && b2.serviced == 0); // never pressed - only their pins read
+	CHECK(b0.reads == 300 && b2.reads == 300);
+	CHECK(pressedAt.size() == 1 && pressedAt[0] == 121 && releasedAt.size() == 1 && releasedAt[0] == 221);
+	// serviced from the press to the end of the release debounce only
+	CHECK(activeScans == 221 - 100 && b1.serviced == activeScans + 1);
+	CHECK(group.activity() == 0);
+}
+
+// a 2 x 2 keypad - the pins of the rows and the columns, the keys pressed (bit c of row r for the key r * 2 + c)
+static const byte matrixRows[2] = { 10, 11 }, matrixCols[2] = { 12, 13 };
+static byte matrixKeys[2];
+// the output level written to each row (HIGH until written - as left by a pull-up) and the row switched to output
+static byte matrixLatch[2] = { HIGH, HIGH };
+static byte matrixDriven = 0xFF;
+static unsigned int matrixDrivenHigh = 0;
+
+/// <summary> Simulates the keypad - a column reads LOW if its key on the row driven LOW is pressed </summary>
+struct MatrixTestHAL : public Sim
+{
+	static void writePin(byte pin, byte level)
+	{
+		for (byte r = 0; r < 2; r++)
+			if (matrixRows[r] == pin)
+				matrixLatch[r] = level;
+	}
+	static void setupPin(byte pin, byte mode)
+	{
+		for (byte r = 0; r < 2; r++)
+			if (matrixRows[r] == pin)
+			{
+				if (mode == OUTPUT && matrixLatch[r] == HIGH)
+					matrixDrivenHigh++;
+				matrixDriven = mode == OUTPUT ? r : 0xFF;
+			}
+	}
+	static int readPin(byte pin)
+	{
+		if (matrixDriven < 2 && matrixLatch[matrixDriven] == LOW)
+			for (byte c = 0; c < 2; c++)
+				if (matrixCols[c] == pin && (matrixKeys[matrixDriven] >> c) & 1)
+					return LOW;
+		return HIGH;
+	}
+};
+
+// the rows are written LOW before they are driven, the keys are debounced by the DEBOUNCER policy
+static void testMatrix()
+{
+	PushButtonMatrix<2, 2, MatrixTestHAL> window(matrixRows, matrixCols, 500, 100, 20);
+	PushButtonMatrix<2, 2, MatrixTestHAL, PushButtonIntegrator> integrator(matrixRows, matrixCols, 500, 100, 20);
+	window.init();
+	integrator.init();
+	KeyCounter windowKeys = { 0, 0 }, integratorKeys = { 0, 0 };
+	auto fw = [&windowKeys](byte key, ButtonEvent e) { if (key == 3) windowKeys(e); };
+	auto fi = [&integratorKeys](byte key, ButtonEvent e) { if (key == 3) integratorKeys(e); };
+
+	// noise on key 3 - single samples pressed at 0 and 21 ms: the time window takes the sample at
+	// the end of the debounce period, the integrator sees the samples in between
+	for (unsigned long t = 0; t < 100; t++)
+	{
+		matrixKeys[1] = (t == 0 || t == 21) ? 2 : 0;
+		window.handle(t, fw);
+		integrator.handle(t, fi);
+	}
+	CHECK(windowKeys.keypresses == 1);
+	CHECK(integratorKeys.keypresses == 0);
+
+	// a clean press is taken by both
+	matrixKeys[1] = 2;
+	for (unsigned long t = 100; t < 200; t++)
+	{
+		window.handle(t, fw);
+		integrator.handle(t, fi);
+	}
+	CHECK(integrator.isDown(3));
+	CHECK(integratorKeys.keypresses == 1);
+	CHECK(!integrator.isDown(0) && !integrator.isDown(1) && !integrator.isDown(2));
+	CHECK(matrixDrivenHigh == 0);
+}
+
+// a chain of 74HC165 shift registers on the LOAD, CLK and DATA pins
+const byte SR_LOAD = 20, SR_CLK = 21, SR_DATA = 22;
+
+/// <summary> Simulates a 74HC165 chain - LOW on LOAD latches the inputs, each rising edge of CLK shifts them by one,
+/// DATA is QH of the register at the MCU, fed by the ones after it (the SER input of the last one is tied LOW) </summary>
+struct ShiftChainHAL : public Sim
+{
+	static uint32_t inputs; // input n of register i is bit 8*i + n
+	static byte bytes; // the length of the chain
+	static uint32_t latched;
+	static byte shifted, clock;
+
+	static void writePin(byte pin, byte level)
+	{
+		if (pin == SR_LOAD && level == LOW)
+		{
+			latched = inputs;
+			shifted = 0;
+		}
+		if (pin == SR_CLK)
+		{
+			if (level == HIGH && clock == LOW)
+				shifted++;
+			clock = level;
+		}
+	}
+	static int readPin(byte pin)
+	{
+		if (pin != SR_DATA || shifted >= 8 * bytes)
+			return LOW;
+		return (latched >> (8 * (shifted / 8) + 7 - shifted % 8)) & 1 ? HIGH : LOW; // input H comes first
+	}
+};
+uint32_t ShiftChainHAL::inputs = 0, ShiftChainHAL::latched = 0;
+byte ShiftChainHAL::bytes = 0, ShiftChainHAL::shifted = 0, ShiftChainHAL::clock = LOW;
+
+/// <summary> Reads the chain of BYTES registers with a walking one and a mixed pattern on the inputs </summary>
+template < byte BYTES >
+static void checkShiftInOrder()
+{
+	typedef PushButtonShiftIn<SR_LOAD, SR_CLK, SR_DATA, BYTES, ShiftChainHAL> Chain;
+	typedef typename Chain::word_type word_type;
+	ShiftChainHAL::bytes = BYTES;
+	Chain::setup();
+	bool ordered = true;
+	for (byte b = 0; b < 8 * BYTES; b++)
+	{
+		ShiftChainHAL::inputs = (uint32_t)1 << b;
+		Chain::begin();
+		ordered = ordered && Chain::finish() == (word_type)ShiftChainHAL::inputs;
+	}
+	CHECK(ordered);
+	ShiftChainHAL::inputs = 0xA5C3F00Ful;
+	Chain::begin();
+	CHECK(Chain::finish() == (word_type)0xA5C3F00Ful);
+}
+
+// the bits of the chains come in the documented order, the bulk device is read once per scan whatever the number of buttons
+static void testBulk()
+{
+	checkShiftInOrder<2>();
+	checkShiftInOrder<4>();
+
+	// the buttons see the inputs latched on the previous update()
+	typedef PushButtonBulkHAL< PushButtonShiftIn<SR_LOAD, SR_CLK, SR_DATA, 2, ShiftChainHAL>, Sim > Chain;
+	ShiftChainHAL::bytes = 2;
+	ShiftChainHAL::inputs = 0xFFFF;
+	Chain::begin();
+	ShiftChainHAL::inputs = 0xFEFF; // input A of the second register
+	Chain::update();
+	CHECK(Chain::readPin(8) == HIGH);
+	Chain::update();
+	CHECK(Chain::readPin(8) == LOW && Chain::readPin(0) == HIGH && Chain::inputs() == 0xFEFF);
+
+	// the host device on the simulated pins 30 .. 61
+	const byte FIRST = 30;
+	typedef PushButtonHostDevice<FIRST, 4> Device;
+	typedef PushButtonBulkHAL<Device, Sim> Panel;
+	Sim::reset();
+	for (byte i = 0; i < 32; i++)
+		Sim::setupPin(FIRST + i, INPUT_PULLUP);
+	Panel::begin();
+	bool ordered = true;
+	for (byte b = 0; b < 32; b++)
+	{
+		Sim::setPin(FIRST + b, LOW);
+		Panel::update();
+		Panel::update();
+		ordered = ordered && Panel::inputs() == ~((uint32_t)1 << b) && Panel::readPin(b) == LOW;
+		Sim::setPin(FIRST + b, HIGH);
+	}
+	CHECK(ordered);
+
+	PushButton<false, Panel> a(0, 20), b(9, 20), c(31, 20);
+	a.init();
+	b.init();
+	c.init();
+	Panel::update();
+	Panel::update();
+	Device::resetTransfers();
+	unsigned int pressed = 0;
+	for (unsigned long t = 1; t <= 200; t++)
+	{
+		Sim::setTime(t);
+		if (t == 50)
+			Sim::setPin(FIRST + 9, LOW);
+		Panel::update();
+		pressed += a.stateChanged(t) == BUTTON_PRESSED;
+		pressed += b.stateChanged(t) == BUTTON_PRESSED;
+		pressed += c.stateChanged(t) == BUTTON_PRESSED;
+	}
+	CHECK(Device::transfers() == 200);
+	CHECK(pressed == 1 && b.isDown() && !a.isDown() && !c.isDown());
+}
+
+// a tap, a second press 40 ms after its release (within the tap gap) held until 500 ms
+static const PushButtonHostEdge twoTaps[] =
+{
+	{ 0, LOW }, { 100, HIGH }, { 140, LOW }, { 500, HIGH }
+};
+
+/// <summary> Runs a gesture recognizer on twoTaps, polled every ms except from stallFrom to stallTo </summary>
+/// <returns> the gestures reported, each followed by the time it was reported at </returns>
+static std::vector<unsigned long> runGestures(unsigned long stallFrom, unsigned long stallTo)
+{
+	Sim::reset();
+	Sim::setWaveform(PB_PIN, twoTaps, sizeof(twoTaps) / sizeof(twoTaps[0]));
+	PushButtonGestures<false, Sim> button(PB_PIN, 800, 250, 255, 20);
+	button.init();
+	std::vector<unsigned long> gestures;
+	for (unsigned long t = 1; t <= 2000; t++)
+	{
+		if (t > stallFrom && t < stallTo)
+			continue;
+		Sim::setTime(t);
+		byte g = button.update(t);
+		if (g != GESTURE_NONE)
+		{
+			gestures.push_back(g);
+			gestures.push_back(t);
+		}
+	}
+	return gestures;
+}
+
+// the gestures count the presses and releases at the time their edges were seen, whenever the loop gets to report them
+static void testGestureStall()
+{
+	std::vector<unsigned long> polled = runGestures(2000, 2000);
+	CHECK(polled.size() == 2 && polled[0] == GESTURE_DOUBLE_CLICK);
+
+	// the press is seen at 145 ms, within the gap, its debounce completes at 400 ms, after the gap - still a double click
+	std::vector<unsigned long> stalled = runGestures(145, 400);
+	CHECK(stalled == polled);
+
+	// the loop stalls before the press is seen - it is seen at 400 ms, after the gap, and starts a new gesture
+	std::vector<unsigned long> late = runGestures(130, 400);
+	CHECK(late.size() == 4);
+	CHECK(late.size() == 4 && late[0] == GESTURE_CLICK && late[1] == 400);
+	CHECK(late.size() == 4 && late[2] == GESTURE_CLICK && late[3] > 500);
+}
+
+/// <summary> A keypress reported - the time, the kind and the number of keypresses it stands for </summary>
+struct Keypress
+{
+	unsigned long t;
+	byte kind;
+	unsigned int count;
+};
+
+/// <summary> Holds the button pressed for 6 s, polled every ms except from stallFrom to stallTo </summary>
+/// <returns> the keypresses reported </returns>
+template < class B >
+static std::vector<Keypress> holdButton(B &b, unsigned long stallFrom, unsigned long stallTo)
+{
+	Sim::reset();
+	b.init();
+	Sim::setPin(PB_PIN, LOW);
+	std::vector<Keypress> log;
+	for (unsigned long t = 1; t <= 6000; t++)
+	{
+		if (t > stallFrom && t < stallTo)
+			continue;
+		Sim::setTime(t);
+		b.handle(t, [&log, t](ButtonEvent e) { Keypress k = { t, e.kind, e.count }; log.push_back(k); });
+	}
+	return log;
+}
+
+/// <summary> The kinds of the keypresses one by one (an event counting n keypresses gives n) </summary>
+static std::vector<byte> keypressKinds(const std::vector<Keypress> &log)
+{
+	std::vector<byte> kinds;
+	for (size_t i = 0; i < log.size(); i++)
+		kinds.insert(kinds.end(), log[i].count, log[i].kind);
+	return kinds;
+}
+
+/// <summary> The times and kinds of the keypresses reported after the given time </summary>
+static std::vector<unsigned long> keypressesAfter(const std::vector<Keypress> &log, unsigned long from)
+{
+	std::vector<unsigned long> r;
+	for (size_t i = 0; i < log.size(); i++)
+		if (log[i].t > from)
+		{
+			r.push_back(log[i].t);
+			r.push_back(log[i].kind);
+		}
+	return r;
+}
+
+/// <summary> Checks the keypresses of a stalled loop against the ones polled on every tick </summary>
+/// <remarks> BURST and COUNT report every keypress due with the kind of its own step, all three policies
+/// leave the schedule in the same place - the keypresses after the stall come at the same times </remarks>
+static void checkCatchUp(const std::vector<Keypress> &polled, const std::vector<Keypress> &skip, 
+	const std::vector<Keypress> &burst, const std::vector<Keypress> &count, unsigned long stallTo)
+{
+	std::vector<byte> kinds = keypressKinds(polled);
+	CHECK(keypressKinds(burst) == kinds);
+	CHECK(keypressKinds(count) == kinds);
+	std::vector<unsigned long> after = keypressesAfter(polled, stallTo);
+	CHECK(after.size() > 10);
+	CHECK(keypressesAfter(skip, stallTo) == after);
+	CHECK(keypressesAfter(burst, stallTo) == after);
+	CHECK(keypressesAfter(count, stallTo) == after);
+	bool bothKinds = false; // the stall crosses a change of the kind
+	for (size_t i = 0; i < burst.size(); i++)
+		bothKinds = bothKinds || (burst[i].t == stallTo && burst[i].kind != burst[1].kind);
+	CHECK(bothKinds);
+}
+
+/// <summary> Runs a button class with each catch-up policy through the stall and checks it </summary>
+template < class B, class M >
+static void checkCatchUpPolicies(M make, unsigned long stallFrom, unsigned long stallTo)
+{
+	B polled = make(BUTTON_CATCHUP_SKIP), skip = make(BUTTON_CATCHUP_SKIP), burst = make(BUTTON_CATCHUP_BURST), 
+		count = make(BUTTON_CATCHUP_COUNT);
+	std::vector<Keypress> p = holdButton(polled, 6000, 6000), s = holdButton(skip, stallFrom, stallTo), 
+		b = holdButton(burst, stallFrom, stallTo), c = holdButton(count, stallFrom, stallTo);
+	checkCatchUp(p, s, b, c, stallTo);
+}
+
+static const uint16_t testCurve[] = { 200, 150, 100, 60, 30 };
+
+// a stall across the steps of the accelerating schedules - every keypress due is stepped through
+static void testCatchUpAcceleration()
+{
+	typedef PushButtonAutoAcceleratedRepeat<false, Sim> Accelerated;
+	checkCatchUpPolicies<Accelerated>([](byte policy)
+	{
+		Accelerated b(PB_PIN, NULL, 500, 200, 2000, 10, 20, 20);
+		b.setCatchUp(policy);
+		return b;
+	}, 600, 3000);
+
+	typedef PushButton2SpeedAutoRepeat<false, Sim> TwoSpeed;
+	checkCatchUpPolicies<TwoSpeed>([](byte policy)
+	{
+		TwoSpeed b(PB_PIN, NULL, 500, 200, 2000, 50, 20);
+		b.setCatchUp(policy);
+		return b;
+	}, 1500, 2600);
+
+	typedef PushButtonCurveAutoRepeat<false, Sim> Curve;
+	checkCatchUpPolicies<Curve>([](byte policy)
+	{
+		Curve b(PB_PIN, NULL, testCurve, sizeof(testCurve) / sizeof(testCurve[0]), 500, 20);
+		b.setCatchUp(policy);
+		return b;
+	}, 600, 1500);
+
+	// the compile-time configured class with each policy
+	PushButtonAutoAcceleratedRepeatStatic<PB_PIN, false, 500, 200, 2000, 10, 20, 20, Sim, BUTTON_CATCHUP_SKIP> polled, skip;
+	PushButtonAutoAcceleratedRepeatStatic<PB_PIN, false, 500, 200, 2000, 10, 20, 20, Sim, BUTTON_CATCHUP_BURST> burst;
+	PushButtonAutoAcceleratedRepeatStatic<PB_PIN, false, 500, 200, 2000, 10, 20, 20, Sim, BUTTON_CATCHUP_COUNT> count;
+	std::vector<Keypress> p = holdButton(polled, 6000, 6000), s = holdButton(skip, 600, 3000), 
+		b = holdButton(burst, 600, 3000), c = holdButton(count, 600, 3000);
+	checkCatchUp(p, s, b, c, 3000);
+}
+
+// the curve tables computed at compile time
+static_assert(PushButtonExponentialCurve<300, 20, 10>::period(3) == 218, "exponential curve");
+static_assert(PushButtonExponentialCurve<300, 20, 50>::period(9) == 20, "exponential curve stops at TO");
+static_assert(PushButtonLinearCurve<200, 50, 40>::period(3) == 80 && PushButtonLinearCurve<200, 50, 40>::period(4) == 50, "linear curve");
+static_assert(PushButtonSCurve<200, 100, 4>::period(2) == 150 && PushButtonSCurve<200, 100, 4>::period(9) == 100, "S curve");
+
+// the autorepeat steps one entry of the curve further on each keypress and stays at the last one,
+// the keypresses after the period got shorter than the first one are accelerated
+static void testCurveSteps()
+{
+	typedef PushButtonCurveTable<PushButtonLinearCurve<200, 50, 40>, 6> Table;
+	CHECK(Table::length == 6 && Table::table[0] == 200 && Table::table[2] == 120 && Table::table[5] == 50);
+
+	PushButtonCurveAutoRepeat<false, Sim> b(PB_PIN, NULL, testCurve, sizeof(testCurve) / sizeof(testCurve[0]), 500, 20);
+	std::vector<Keypress> log = holdButton(b, 6000, 6000);
+	CHECK(log.size() > 10);
+	// the press, the repeat delay (from the first edge at 2 ms), then 200, 150, 100, 60 and 30 ms from then on
+	const unsigned long times[] = { 22, 502, 702, 852, 952, 1012, 1042, 1072 };
+	const byte kinds[] = { BUTTON_EVENT_PRESS, BUTTON_EVENT_REPEAT, BUTTON_EVENT_REPEAT, BUTTON_EVENT_ACCELERATED_REPEAT, 
+		BUTTON_EVENT_ACCELERATED_REPEAT, BUTTON_EVENT_ACCELERATED_REPEAT, BUTTON_EVENT_ACCELERATED_REPEAT, BUTTON_EVENT_ACCELERATED_REPEAT };
+	for (size_t i = 0; i < sizeof(times) / sizeof(times[0]) && i < log.size(); i++)
+		CHECK(log[i].t == times[i] && log[i].kind == kinds[i] && log[i].count == 1);
+	CHECK(log.back().t - log[log.size() - 2].t == 30);
+	CHECK(b.getCurveIndex() == 4);
+
+	// released and pressed again - back at the beginning of the curve
+	Sim::setPin(PB_PIN, HIGH);
+	for (unsigned long t = 6001; t <= 6100; t++)
+	{
+		Sim::setTime(t);
+		b.handle(t);
+	}
+	std::vector<Keypress> again;
+	Sim::setPin(PB_PIN, LOW);
+	for (unsigned long t = 6101; t <= 6960; t++)
+	{
+		Sim::setTime(t);
+		b.handle(t, [&again, t](ButtonEvent e) { Keypress k = { t, e.kind, e.count }; again.push_back(k); });
+	}
+	CHECK(again.size() == 4 && again[1].t - again[0].t == 480 && again[2].t - again[1].t == 200 && again[3].t - again[2].t == 150);
+}
+
+static unsigned int plainCalls = 0;
+static void plainCallback()
+{
+	plainCalls++;
+}
+static void eventCallback(void *context, ButtonEvent)
+{
+	++*(unsigned int *)context;
+}
+
+/// <summary> Presses the button, calls handle() for a second and releases it </summary>
+template < class B >
+static void pressAndHandle(B &b)
+{
+	Sim::reset();
+	b.init();
+	Sim::setPin(PB_PIN, LOW);
+	for (unsigned long t = 1; t <= 1000; t++)
+	{
+		Sim::setTime(t);
+		b.handle(t);
+	}
+	Sim::setPin(PB_PIN, HIGH);
+}
+
+/// <summary> Registers the callbacks one after the other and checks which one is called </summary>
+template < class B >
+static void checkCallbacks(B &b)
+{
+	unsigned int events = 0;
+	plainCalls = 0;
+	b.registerKeyEventCallback(eventCallback, &events);
+	pressAndHandle(b);
+	CHECK(events > 1 && plainCalls == 0);
+	// NULL for the function - the context (sharing the storage with the plain callback) must not be called
+	b.registerKeyEventCallback(NULL, &events);
+	events = 0;
+	pressAndHandle(b);
+	CHECK(events == 0 && plainCalls == 0);
+	b.registerKeyPressCallback(plainCallback);
+	pressAndHandle(b);
+	CHECK(events == 0 && plainCalls > 1);
+}
+
+// the callback with a context and the plain callback replace each other
+static void testCallbacks()
+{
+	PushButtonAutoRepeat<false, Sim> dynamic(PB_PIN, plainCallback, 500, 100, 20);
+	checkCallbacks(dynamic);
+	PushButtonAutoRepeatStatic<PB_PIN, false, 500, 100, 20, Sim> fixed(plainCallback);
+	checkCallbacks(fixed);
+}
+
+int main()
+{
+	testQueueCatchUpCount();
+	testQueueEdgeTimes();
+	testRollover();
+	testDelayRange();
+	testShortDebounce();
+	testAdaptiveDebounce();
+	testOverflow();
+	testBankBounce();
+	testLadder();
+	testGroupSkip();
+	testMatrix();
+	testBulk();
+	testGestureStall();
+	testCatchUpAcceleration();
+	testCurveSteps();
+	testCallbacks();
+	printf("%u checks, %u failed\n", checks, failures);
+	return failures ? 1 : 0;
+}
@@ -5,17 +5,36 @@
 // (c) Dejan Gjorgjevikj, 2018
 // 09.11.2023 - added "this->" before some function calls to satisfy modern compilers
 // 02.08.2025 - bunch of spelling mistakes in the comments corrected
+// 15.10.2026 - pins and time accessed through a HAL policy template parameter (allows host builds)
+// 15.10.2026 - timestamps and delays kept in HAL ticks (time_type), optionally 8 or 16 bit wraparound-safe
+// 15.10.2026 - stateChanged(), heldDown() and handle() overloads taking the time sampled once per scan
+// 15.10.2026 - nextEventIn() - the time until the next event, so the MCU can sleep in between
+// 15.10.2026 - isIdle() - released and not debouncing (lets ButtonGroup skip idle buttons)
+// 15.10.2026 - callbacks with user context and event kind, handle(now, f) with inlinable functor
+// 15.10.2026 - isDown() - the debounced state of the button
+// 15.10.2026 - adaptive debounce learning the bounce of each switch (#define YAPUSHBUTTON_ADAPTIVE_DEBOUNCE)
+// 15.10.2026 - debounce algorithm as policy template parameter (time window, integrator, shift register)
+// 15.10.2026 - per button statistics - edges, latency histogram, repeat periods, missed deadlines (#define YAPUSHBUTTON_STATS)
+// 15.10.2026 - drift-free autorepeat on a fixed schedule with a catch-up policy for late calls (skip, burst or count)
+// 15.10.2026 - readAnalog() in the HAL (buttons on a resistor ladder - yaPushButtonLadder.h)
+// 15.10.2026 - writePin() and delayMicros() in the HAL (driving the rows of a keypad matrix - yaPushButtonMatrix.h)
+// 15.10.2026 - getStateChangedTime() - the time the last state change was spotted
 
 #ifndef _YAPUSHBUTTON_h
 #define _YAPUSHBUTTON_h
 
 #define _YAPUSHBUTTON_VERSION 0.91.0.3
 
+#ifndef YAPUSHBUTTON_HOST
 #if defined(ARDUINO) && ARDUINO >= 100
 	#include "arduino.h"
 #else
 	#include "WProgram.h"
 #endif
+#if defined(__AVR__)
+	#include <avr/sleep.h>
+#endif
+#endif
 
 #ifndef NDEBUG
 #define __ASSERT_USE_STDERR
@@ -24,6 +43,236 @@
 
 enum ButtonStateChange { BUTTON_NOCHANGE, BUTTON_PRESSED, BUTTON_RELEASED };
 
+/// <summary> The kind of keypress reported by the autorepeat classes </summary>
+enum ButtonEventKind { BUTTON_EVENT_PRESS, BUTTON_EVENT_REPEAT, BUTTON_EVENT_ACCELERATED_REPEAT };
+
+/// <summary> What the autorepeat classes do when called too late for more than one autorepeated keypress </summary>
+enum ButtonCatchUp 
+{ 
+	BUTTON_CATCHUP_SKIP, // fire one keypress, drop the missed ones (default)
+	BUTTON_CATCHUP_BURST, // fire all the missed keypresses at once
+	BUTTON_CATCHUP_COUNT // fire one keypress with the number of keypresses it stands for in ButtonEvent::count
+};
+
+/// <summary> A keypress reported by the autorepeat classes </summary>
+struct ButtonEvent
+{
+	/// <summary> BUTTON_EVENT_PRESS, BUTTON_EVENT_REPEAT or BUTTON_EVENT_ACCELERATED_REPEAT </summary>
+	byte kind;
+	/// <summary> 0 for the first press, then 1, 2, ... for the autorepeated keypresses while held </summary>
+	unsigned int repeatIndex;
+	/// <summary> the number of keypresses the event stands for - 1, more only with BUTTON_CATCHUP_COUNT </summary>
+	unsigned int count;
+};
+
+#ifndef YAPUSHBUTTON_HOST
+/// <summary>
+/// PushButtonArduinoHAL Class 
+/// </summary>
+/// <remarks>
+/// The hardware access policy used by the button classes - how the pins are read and configured
+/// and where the time comes from. The default one maps directly to the Arduino core functions.
+/// Any class providing the same static functions can be passed as HAL template parameter
+/// (see yaPushButtonHost.h for a host implementation with simulated time and pins) 
+/// time_type is the type the timestamps and the delays are kept in (in ticks of the time source)
+/// </remarks>
+class PushButtonArduinoHAL
+{
+public:
+	/// <summary> the type of the timestamps (ticks are milliseconds here) </summary>
+	typedef unsigned long time_type;
+
+	/// <summary> The current time </summary>
+	/// <returns> the time in milliseconds </returns>
+	static time_type now()
+	{
+		return millis();
+	}
+
+	/// <summary> Converts milliseconds to ticks </summary>
+	static constexpr time_type toTicks(unsigned long ms)
+	{
+		return ms;
+	}
+
+	/// <summary> Converts ticks to milliseconds </summary>
+	static constexpr unsigned long toMillis(time_type ticks)
+	{
+		return ticks;
+	}
+
+	/// <summary> Reads the pin </summary>
+	/// <param name="pin"> The pin to be read </param>
+	/// <returns> HIGH or LOW </returns>
+	static int readPin(byte pin)
+	{
+		return digitalRead(pin);
+	}
+
+	/// <summary> Configures the pin </summary>
+	/// <param name="pin"> The pin to be configured </param>
+	/// <param name="mode"> INPUT or INPUT_PULLUP </param>
+	static void setupPin(byte pin, byte mode)
+	{
+		pinMode(pin, mode);
+	}
+
+	/// <summary> Reads the analog input (only used by the resistor ladder - yaPushButtonLadder.h) </summary>
+	/// <param name="pin"> The analog input to be read </param>
+	/// <returns> the ADC reading </returns>
+	static int readAnalog(byte pin)
+	{
+		return analogRead(pin);
+	}
+
+	/// <summary> Sets the level of the pin (only used to drive the rows of a keypad matrix - yaPushButtonMatrix.h) </summary>
+	/// <param name="pin"> The pin to be written </param>
+	/// <param name="level"> HIGH or LOW </param>
+	static void writePin(byte pin, byte level)
+	{
+		digitalWrite(pin, level);
+	}
+
+	/// <summary> Waits for the given number of microseconds (only used by the keypad matrix to let a row settle) </summary>
+	/// <param name="us"> The time to wait in microseconds </param>
+	static void delayMicros(unsigned int us)
+	{
+		delayMicroseconds(us);
+	}
+
+	/// <summary> Idles the MCU until the next interrupt </summary>
+	/// <remarks> on AVR enters idle sleep mode - woken up by any interrupt, at latest by the 
+	/// timer 0 overflow interrupt that counts the time (about every millisecond) </remarks>
+	static void idle()
+	{
+#if defined(__AVR__)
+		set_sleep_mode(SLEEP_MODE_IDLE);
+		sleep_mode();
+#endif
+	}
+};
+#endif
+
+#ifndef YAPUSHBUTTON_DEFAULT_HAL
+#define YAPUSHBUTTON_DEFAULT_HAL PushButtonArduinoHAL
+#endif
+
+/// <summary>
+/// PushButtonTicksHAL Template Class 
+/// </summary>
+/// <remarks>
+/// Hardware access policy with compact timestamps - the time of the BASE policy is divided 
+/// into ticks of 2^SHIFT milliseconds and kept in T (uint8_t or uint16_t) 
+/// All the timestamps and the delays of a button are kept in T, saving RAM and making the
+/// comparisons cheaper on 8-bit MCUs. The tick counter wraps around every 2^(8*sizeof(T)) ticks,
+/// the elapsed times are computed modulo that, so they are correct across the rollover as long as 
+/// all the delays (and periods) are shorter than half of the range - at most PushButton::maxDelay(),
+/// 32766 ticks for uint16_t and 126 ticks for uint8_t (asserted in debug builds)
+/// Delays are rounded up to whole ticks
+/// </remarks>
+template < typename T = uint16_t, byte SHIFT = 0, class BASE = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonTicksHAL : public BASE
+{
+public:
+	/// <summary> the type of the timestamps (in ticks of 2^SHIFT ms) </summary>
+	typedef T time_type;
+
+	/// <summary> The current time </summary>
+	/// <returns> the time in ticks </returns>
+	static time_type now()
+	{
+		return (time_type)(BASE::toMillis(BASE::now()) >> SHIFT);
+	}
+
+	/// <summary> Converts milliseconds to ticks (rounding up) </summary>
+	static constexpr time_type toTicks(unsigned long ms)
+	{
+		return (time_type)((ms + (1UL << SHIFT) - 1) >> SHIFT);
+	}
+
+	/// <summary> Converts ticks to milliseconds </summary>
+	static constexpr unsigned long toMillis(time_type ticks)
+	{
+		return (unsigned long)ticks << SHIFT;
+	}
+};
+
+/// <summary>
+/// PushButtonTimeWindow Template Class
+/// </summary>
+/// <remarks>
+/// The default debounce policy - after the first edge waits for the debounce delay to pass and
+/// takes the state read at that moment. The cheapest one, but a single noisy sample at the end
+/// of the window decides (see yaPushButtonDebounce.h for the integrator and shift register policies)
+/// A debounce policy is a base class of the button (no memory used if it has no state),
+/// T is the time type of the HAL
+/// </remarks>
+template < typename T >
+class PushButtonTimeWindow
+{
+protected:
+	/// <summary> Starts debouncing a state change </summary>
+	/// <param name="now"> The time the state change has been spotted </param>
+	/// <param name="current"> The new state of the button </param>
+	void debounceStart(T, bool)
+	{ }
+
+	/// <summary> Samples the button while debouncing </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="current"> The state of the button now </param>
+	/// <param name="since"> The time the state change has been spotted </param>
+	/// <param name="delay"> The debounce delay </param>
+	/// <returns> true when the debouncing is over (current is the debounced state) </returns>
+	bool debounceSettled(T now, bool, T since, T delay)
+	{
+		return (T)(now - since) > delay;
+	}
+
+	/// <summary> The time until the debouncing can be over </summary>
+	/// <returns> the time in HAL ticks (0 if it already can) </returns>
+	T debounceNextIn(T now, T since, T delay) const
+	{
+		T elapsed = (T)(now - since);
+		return elapsed > delay ? 0 : (T)(delay - elapsed + 1);
+	}
+};
+
+#ifdef YAPUSHBUTTON_STATS
+#ifndef YAPUSHBUTTON_STATS_BUCKETS
+#define YAPUSHBUTTON_STATS_BUCKETS 8
+#endif
+
+/// <summary> The statistics collected by each button with #define YAPUSHBUTTON_STATS </summary>
+/// <remarks> T is the time type of the HAL, the counters saturate instead of wrapping around </remarks>
+template < typename T >
+struct PushButtonStats
+{
+	/// <summary> the level changes of the pin seen on the samples </summary>
+	unsigned int rawEdges;
+	/// <summary> the presses and releases reported (the other edges have been filtered as bounce) </summary>
+	unsigned int stateChanges;
+	/// <summary> the events reported more than one tick after they were due </summary>
+	unsigned int missedDeadlines;
+	/// <summary> histogram of the time from the first edge of a press to its report,
+	/// bucket i counts the latencies below 4*2^i ms, the last one all the longer ones </summary>
+	unsigned int latency[YAPUSHBUTTON_STATS_BUCKETS];
+	/// <summary> the autorepeated keypresses measured </summary>
+	unsigned int repeats;
+	/// <summary> the shortest time between two autorepeated keypresses </summary>
+	T repeatMin;
+	/// <summary> the longest time between two autorepeated keypresses </summary>
+	T repeatMax;
+	/// <summary> the sum of the times between the autorepeated keypresses </summary>
+	unsigned long repeatSum;
+	/// <summary> the sum of the repeat periods configured for them </summary>
+	unsigned long repeatConfiguredSum;
+	/// <summary> the time of the last autorepeated keypress </summary>
+	T lastRepeat;
+	/// <summary> the state of the pin on the last sample </summary>
+	bool raw;
+};
+#endif
+
 /// <summary>
 /// PushButton Template Class 
 /// </summary>
@@ -32,20 +281,27 @@ enum ButtonStateChange { BUTTON_NOCHANGE, BUTTON_PRESSED, BUTTON_RELEASED };
 /// ACT determines active low = false (default) 
 /// - push button that connects to GND when pressed 
 /// or active high push button
+/// DEBOUNCER is the debounce policy (PushButtonTimeWindow by default)
 /// </remarks>
-template < bool ACT = false >
-class PushButton
+template < bool ACT = false, class HAL = YAPUSHBUTTON_DEFAULT_HAL, template < typename > class DEBOUNCER = PushButtonTimeWindow >
+class PushButton : protected DEBOUNCER<typename HAL::time_type>
 {
+ public:
+	 /// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	 typedef typename HAL::time_type time_type;
+	 /// <summary> the hardware access policy of the button </summary>
+	 typedef HAL hal_type;
+
  protected:
 // configuration
 	 /// <summary> the pin the button is connected to </summary>
 	 byte pin;
 	 /// <summary> the time for debouncing (maybe should be static ... if common for all buttons) </summary>
-	 unsigned long debounceDelay; 
+	 time_type debounceDelay; 
 
 // operation
 /// <summary> the last time the output pin was toggled </summary> 
-	 unsigned long stateChangedTimeStamp;  
+	 time_type stateChangedTimeStamp;  
 /// <summary> true while waiting for button to stabilize - waiting for the debounce time to pass </summary> 
 	 bool debounceWaiting : 1; 
 /// <summary> the previous state of the button </summary> 
@@ -53,20 +309,187 @@ class PushButton
 
 /// <summary> !!! used for autorepeat feature in derived class PushButtonAutoRepeat but allocated here as bit field to save memory </summary> 
 	 bool singlePress : 1 ; 
+/// <summary> the catch-up policy of the autorepeat (ButtonCatchUp) - allocated here as bit field as well </summary> 
+	 byte catchUp : 2 ; 
+
+#ifdef YAPUSHBUTTON_ADAPTIVE_DEBOUNCE
+// adaptive debounce
+	 /// <summary> the lower bound of the learned debounce delay </summary>
+	 time_type minDebounceDelay;
+	 /// <summary> the upper bound of the learned debounce delay (0 - adaptive debounce off) </summary>
+	 time_type maxDebounceDelay;
+	 /// <summary> the (slowly decaying) maximum of the settle times measured </summary>
+	 time_type learnedSettle;
+	 /// <summary> the time of the last edge seen while debouncing </summary>
+	 time_type lastEdgeTime;
+	 /// <summary> the settle time (first to last edge) of the last state change </summary>
+	 time_type lastSettle;
+	 /// <summary> the edges seen while debouncing the current state change </summary>
+	 byte bounceEdges;
+	 /// <summary> the edges seen while debouncing the last state change </summary>
+	 byte lastBounceEdges;
+	 /// <summary> the state of the pin on the last sample while debouncing </summary>
+	 bool bounceRaw;
+#endif
+
+#ifdef YAPUSHBUTTON_STATS
+	 /// <summary> the statistics of the button </summary>
+	 PushButtonStats<time_type> stats;
+
+	 /// <summary> Increments a statistics counter unless it is at its maximum </summary>
+	 static void statsCount(unsigned int &counter)
+	 {
+		 if (counter != (unsigned int)~0U)
+			 counter++;
+	 }
+#endif
+
+	 /// <summary> Starts measuring the bounce of a state change (adaptive debounce) </summary>
+	 /// <param name="current"> The state of the button that started the debouncing </param>
+	 void bounceStart(bool current)
+	 {
+#ifdef YAPUSHBUTTON_ADAPTIVE_DEBOUNCE
+		 bounceRaw = current;
+		 bounceEdges = 0;
+		 lastEdgeTime = stateChangedTimeStamp;
+#else
+		 (void)current;
+#endif
+	 }
+
+	 /// <summary> Counts the edges while debouncing (adaptive debounce) </summary>
+	 /// <param name="now"> The current time </param>
+	 /// <param name="current"> The state of the button now </param>
+	 void bounceSample(time_type now, bool current)
+	 {
+#ifdef YAPUSHBUTTON_ADAPTIVE_DEBOUNCE
+		 if (current != bounceRaw)
+		 {
+			 bounceRaw = current;
+			 if (bounceEdges < 255)
+				 bounceEdges++;
+			 lastEdgeTime = now;
+		 }
+#else
+		 (void)now;
+		 (void)current;
+#endif
+	 }
+
+	 /// <summary> Counts the level changes of the pin (statistics) </summary>
+	 /// <param name="current"> The state of the button now </param>
+	 void statsSample(bool current)
+	 {
+#ifdef YAPUSHBUTTON_STATS
+		 if (current != stats.raw)
+		 {
+			 stats.raw = current;
+			 statsCount(stats.rawEdges);
+		 }
+#else
+		 (void)current;
+#endif
+	 }
+
+	 /// <summary> Records a reported press or release - the latency of the press and if it has been late (statistics) </summary>
+	 /// <param name="now"> The current time </param>
+	 /// <param name="change"> BUTTON_PRESSED or BUTTON_RELEASED </param>
+	 /// <remarks> an event is late if reported more than one tick after the debounce delay has passed </remarks>
+	 void statsReport(time_type now, byte change)
+	 {
+#ifdef YAPUSHBUTTON_STATS
+		 statsCount(stats.stateChanges);
+		 time_type waited = (time_type)(now - stateChangedTimeStamp);
+		 if (waited > (time_type)(debounceDelay + 1))
+			 statsCount(stats.missedDeadlines);
+		 if (change == BUTTON_PRESSED)
+		 {
+			 unsigned long ms = HAL::toMillis(waited);
+			 byte i = 0;
+			 while (i < YAPUSHBUTTON_STATS_BUCKETS - 1 && ms >= (4UL << i))
+				 i++;
+			 statsCount(stats.latency[i]);
+		 }
+#else
+		 (void)now;
+		 (void)change;
+#endif
+	 }
+
+	 /// <summary> Records an autorepeated keypress - the time since the previous one and if it has been late (statistics) </summary>
+	 /// <param name="now"> The current time </param>
+	 /// <param name="period"> The repeat period configured </param>
+	 /// <param name="late"> For how long the keypress has been due </param>
+	 /// <param name="first"> Is it the first autorepeated keypress (it follows the repeat delay, not a period) </param>
+	 void statsRepeat(time_type now, time_type period, time_type late, bool first)
+	 {
+#ifdef YAPUSHBUTTON_STATS
+		 if (!first)
+		 {
+			 time_type actual = (time_type)(now - stats.lastRepeat);
+			 if (!stats.repeats || actual < stats.repeatMin)
+				 stats.repeatMin = actual;
+			 if (!stats.repeats || actual > stats.repeatMax)
+				 stats.repeatMax = actual;
+			 statsCount(stats.repeats);
+			 stats.repeatSum += actual;
+			 stats.repeatConfiguredSum += period;
+		 }
+		 stats.lastRepeat = now;
+		 if (late)
+			 statsCount(stats.missedDeadlines);
+#else
+		 (void)now;
+		 (void)period;
+		 (void)late;
+		 (void)first;
+#endif
+	 }
+
+	 /// <summary> Learns from the bounce of the state change just debounced and tunes the debounce delay (adaptive debounce) </summary>
+	 /// <remarks> the learned settle time follows a longer bounce at once and decays by 1/8 per state change 
+	 /// towards shorter ones, the debounce delay is twice the learned settle time within the bounds </remarks>
+	 void bounceLearn()
+	 {
+#ifdef YAPUSHBUTTON_ADAPTIVE_DEBOUNCE
+		 lastBounceEdges = bounceEdges;
+		 lastSettle = (time_type)(lastEdgeTime - stateChangedTimeStamp);
+		 if (!maxDebounceDelay)
+			 return;
+		 if (lastSettle >= learnedSettle)
+			 learnedSettle = lastSettle;
+		 else
+			 learnedSettle -= (time_type)((learnedSettle - lastSettle + 7) / 8);
+		 time_type d = (time_type)(learnedSettle * 2);
+		 if (d < learnedSettle || d > maxDebounceDelay) // (overflow)
+			 d = maxDebounceDelay;
+		 debounceDelay = d < minDebounceDelay ? minDebounceDelay : d;
+#endif
+	 }
 
  public:
 	 /// <summary> PushButton constructor </summary>
 	 /// <param name="pbPin"> The pin the button is connected to </param>
 	 /// <param name="DebounceDelay"> The delay in milliseconds for debouncing </param>
 	PushButton(byte pbPin, unsigned long DebounceDelay = 50) : 
-		pin(pbPin), debounceDelay(DebounceDelay), 
+		pin(pbPin), debounceDelay(delayTicks(DebounceDelay)), stateChangedTimeStamp(0), 
 		debounceWaiting(false), previousButtonState(false) 
-	{ }
+	{
+#ifdef YAPUSHBUTTON_ADAPTIVE_DEBOUNCE
+		maxDebounceDelay = 0; // adaptive debounce off
+		learnedSettle = lastSettle = 0;
+		bounceEdges = lastBounceEdges = 0;
+#endif
+#ifdef YAPUSHBUTTON_STATS
+		resetStats();
+		stats.raw = false;
+#endif
+	}
 
 	/// <summary> initializes the PushButton object </summary>
 	void init()
 	{
-		pinMode(pin, ACT ? INPUT : INPUT_PULLUP); // active low	
+		HAL::setupPin(pin, ACT ? INPUT : INPUT_PULLUP); // active low	
 		// stateChangedTimeStamp = 0;
 		debounceWaiting = false; // not in debounce
 		previousButtonState = false; // not pressed
@@ -96,22 +519,118 @@ class PushButton
 	/// <param name="delay"> The delay in milliseconds for debouncing </param>
 	void setDebounceDelay(unsigned long delay)
 	{
-		debounceDelay = delay;
+		debounceDelay = delayTicks(delay);
 	}
 
 	/// <summary> Gets the debouncing delay </summary>
 	/// <returns> the debouncing delay in milliseconds </returns>
 	unsigned long getDebounceDelay() const
 	{
-		return debounceDelay;
+		return HAL::toMillis(debounceDelay);
 	}
 
+#ifdef YAPUSHBUTTON_ADAPTIVE_DEBOUNCE
+	/// <summary> Turns on adaptive debounce - the debounce delay is tuned to the bounce measured on each state change </summary>
+	/// <param name="minDelay"> The shortest debounce delay in milliseconds </param>
+	/// <param name="maxDelay"> The longest debounce delay in milliseconds, not shorter than minDelay (0 turns adaptive debounce off) </param>
+	/// <remarks> the debounce delay starts at maxDelay and shrinks as the switch proves to bounce less
+	/// The bounce is measured from the samples taken while debouncing, so stateChanged() / handle()
+	/// has to be called more often than the switch bounces (every millisecond or so) </remarks>
+	void setAdaptiveDebounce(unsigned long minDelay, unsigned long maxDelay)
+	{
+#ifndef NDEBUG
+		assert(!maxDelay || minDelay <= maxDelay);
+#endif
+		minDebounceDelay = delayTicks(minDelay);
+		maxDebounceDelay = delayTicks(maxDelay);
+		learnedSettle = (time_type)(maxDebounceDelay / 2);
+		if (maxDebounceDelay)
+			debounceDelay = maxDebounceDelay;
+	}
+
+	/// <summary> The number of edges seen while debouncing the last state change </summary>
+	/// <returns> the number of bounces of the last press or release </returns>
+	byte getBounceEdges() const
+	{
+		return lastBounceEdges;
+	}
+
+	/// <summary> The time from the first to the last edge of the last state change </summary>
+	/// <returns> the settle time in milliseconds </returns>
+	unsigned long getSettleTime() const
+	{
+		return HAL::toMillis(lastSettle);
+	}
+
+	/// <summary> The settle time learned from the state changes so far </summary>
+	/// <returns> the learned settle time in milliseconds (the debounce delay is twice that, within the bounds) </returns>
+	unsigned long getLearnedSettleTime() const
+	{
+		return HAL::toMillis(learnedSettle);
+	}
+#endif
+
+#ifdef YAPUSHBUTTON_STATS
+	/// <summary> The statistics collected since the last reset </summary>
+	/// <returns> the counters, the times in HAL ticks </returns>
+	const PushButtonStats<time_type> &getStats() const
+	{
+		return stats;
+	}
+
+	/// <summary> Clears the statistics </summary>
+	void resetStats()
+	{
+		bool raw = stats.raw;
+		stats = PushButtonStats<time_type>();
+		stats.raw = raw;
+	}
+
+	/// <summary> Prints the statistics </summary>
+	/// <param name="out"> Where to print them - Serial or any object with print() and println() </param>
+	/// <remarks> the times are printed in milliseconds </remarks>
+	template < class P >
+	void dumpStats(P &out) const
+	{
+		out.print("edges ");
+		out.print((unsigned long)stats.rawEdges);
+		out.print(" filtered ");
+		out.print((unsigned long)(stats.rawEdges > stats.stateChanges ? stats.rawEdges - stats.stateChanges : 0));
+		out.print(" changes ");
+		out.print((unsigned long)stats.stateChanges);
+		out.print(" missed ");
+		out.println((unsigned long)stats.missedDeadlines);
+		out.print("latency");
+		for (byte i = 0; i < YAPUSHBUTTON_STATS_BUCKETS; i++)
+		{
+			out.print(i < YAPUSHBUTTON_STATS_BUCKETS - 1 ? " <" : " >=");
+			out.print(4UL << (i < YAPUSHBUTTON_STATS_BUCKETS - 1 ? i : i - 1));
+			out.print(":");
+			out.print((unsigned long)stats.latency[i]);
+		}
+		out.println();
+		if (stats.repeats)
+		{
+			out.print("repeat ");
+			out.print((unsigned long)stats.repeats);
+			out.print(" min ");
+			out.print(HAL::toMillis(stats.repeatMin));
+			out.print(" max ");
+			out.print(HAL::toMillis(stats.repeatMax));
+			out.print(" mean ");
+			out.print(HAL::toMillis((time_type)(stats.repeatSum / stats.repeats)));
+			out.print(" configured ");
+			out.println(HAL::toMillis((time_type)(stats.repeatConfiguredSum / stats.repeats)));
+		}
+	}
+#endif
+
 	/// <summary> Is the button (held) pressed or not </summary>
 	/// <returns> true if the button is pressed in the moment </returns>
 	bool isPressed()
 	{
 		// if ACT is false (button active low) being pressedDebounced means reding low signal
-		return ACT ? digitalRead(pin) : !digitalRead(pin);
+		return ACT ? HAL::readPin(pin) : !HAL::readPin(pin);
 	}
 
 	/// <summary> Detect state change of a button </summary>
@@ -121,18 +640,32 @@ class PushButton
 	/// otherwise returns BUTTON_NOCHANGE.
 	/// To be called repeatedly in a loop </remark>
 	byte stateChanged()
+	{
+		return stateChanged(HAL::now());
+	}
+
+	/// <summary> Detect state change of a button at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	byte stateChanged(time_type now)
 	{
 		byte r = BUTTON_NOCHANGE; 
 		bool currentButtonState = isPressed(); // read the state of the button
+		statsSample(currentButtonState);
 
 		if (debounceWaiting) // are we waiting for the debounce period to pass?
 		{
-			if (millis() - stateChangedTimeStamp > debounceDelay) // been waiting long enough
+			bounceSample(now, currentButtonState);
+			if (this->debounceSettled(now, currentButtonState, stateChangedTimeStamp, debounceDelay)) // been waiting long enough
 			{
 				if (previousButtonState ^ currentButtonState) // is last recorded previous state different from current 
+				{
 					r = (previousButtonState<<1) | currentButtonState;
+					statsReport(now, r);
+				}
 				debounceWaiting = false;
 				previousButtonState = currentButtonState; // change current state
+				bounceLearn();
 			}
 		}
 		else // !debounceWaiting
@@ -140,11 +673,227 @@ class PushButton
 			if (previousButtonState ^ currentButtonState) // has been pressed (was up and is down now) or release (was down and is up now)
 			{
 				debounceWaiting = true; // mark that we are starting the wait to stabilize 
-				stateChangedTimeStamp = millis(); // mark the time the state change was spotted
+				stateChangedTimeStamp = now; // mark the time the state change was spotted
+				this->debounceStart(now, currentButtonState);
+				bounceStart(currentButtonState);
 			} // still return no-change at this point...
 		}
 		return r;
 	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until the debounce period expires (0 if it already has) 
+	/// or maxTime() if only a press or release can produce the next event </returns>
+	/// <remark> stateChanged() does not need to be called before that time unless the pin changes </remark>
+	time_type nextEventIn(time_type now) const
+	{
+		if (debounceWaiting)
+			return this->debounceNextIn(now, stateChangedTimeStamp, debounceDelay);
+		return maxTime();
+	}
+
+	/// <summary> Is the button down (debounced) </summary>
+	/// <returns> true while the button is (debounced) pressed </returns>
+	/// <remark> does not read the pin, the state changes when stateChanged() reports the change </remark>
+	bool isDown() const
+	{
+		return previousButtonState;
+	}
+
+	/// <summary> The time the last state change of the button was spotted </summary>
+	/// <returns> the time (HAL ticks) of the edge that started the debouncing - once the change is reported, the time it happened </returns>
+	time_type getStateChangedTime() const
+	{
+		return stateChangedTimeStamp;
+	}
+
+	/// <summary> Is the button idle - released and not waiting for the debounce time to pass </summary>
+	/// <returns> true if only pressing the button can produce the next event </returns>
+	/// <remark> does not read the pin </remark>
+	bool isIdle() const
+	{
+		return !debounceWaiting && !previousButtonState;
+	}
+
+	/// <summary> The longest time that can be represented (returned when no event is due) </summary>
+	/// <returns> the maximum value of time_type </returns>
+	static time_type maxTime()
+	{
+		return (time_type)~(time_type)0;
+	}
+
+	/// <summary> The longest delay or period that can be kept in time_type </summary>
+	/// <returns> the time in milliseconds - 126 ticks with 8-bit, 32766 ticks with 16-bit time_type </returns>
+	/// <remark> the elapsed times are computed modulo the range of time_type and the time the button is
+	/// held saturates at half of it, so the delays and periods have to be shorter than that </remark>
+	static constexpr unsigned long maxDelay()
+	{
+		return HAL::toMillis((time_type)(((time_type)~(time_type)0 >> 1) - 1));
+	}
+
+	/// <summary> Converts a delay or period in milliseconds to HAL ticks </summary>
+	/// <param name="ms"> The delay in milliseconds, at most maxDelay() (asserted in debug builds) </param>
+	/// <returns> the delay in HAL ticks (rounded up) </returns>
+	static time_type delayTicks(unsigned long ms)
+	{
+#ifndef NDEBUG
+		assert(ms <= maxDelay());
+#endif
+		return HAL::toTicks(ms);
+	}
+
+	/// <summary> The time until more than period has passed since the given time </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="since"> The start of the period </param>
+	/// <param name="period"> The period </param>
+	/// <returns> the time in HAL ticks, 0 if it has already passed </returns>
+	static time_type untilElapsed(time_type now, time_type since, time_type period)
+	{
+		time_type elapsed = (time_type)(now - since);
+		return elapsed > period ? 0 : (time_type)(period - elapsed + 1);
+	}
+};
+
+/// <summary>
+/// PushButtonRepeatSchedule Template Class
+/// </summary>
+/// <remarks>
+/// The autorepeat schedule shared by all the autorepeat classes (PushButtonAutoRepeat and the classes derived
+/// from it, the compile-time configured ones and the keypad matrix). The keypresses are due on a fixed schedule -
+/// each a period after the previous one was due (the period may change with each keypress - acceleration, curves),
+/// so a late call does not delay the following ones. If more than one is due the catch-up policy decides what is fired. The state of the schedule is kept by the caller, T is the time type of the HAL
+/// </remarks>
+template < typename T >
+class PushButtonRepeatSchedule
+{
+public:
+	/// <summary> For how long the button has been held pressed, saturating at half of the range of T </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="since"> The time the button has been pressed - moved forward when the duration saturates </param>
+	/// <returns> the time in HAL ticks </returns>
+	static T held(T now, T &since)
+	{
+		const T maxHeld = ((T)~(T)0) >> 1;
+		T r = (T)(now - since);
+		if (r > maxHeld) // held for so long that the duration would wrap around - keep it at maximum
+		{
+			r = maxHeld;
+			since = (T)(now - maxHeld);
+		}
+		return r;
+	}
+
+	/// <summary> A schedule with the same period and kind for all the keypresses </summary>
+	struct Steady
+	{
+		/// <summary> the period in HAL ticks (0 - a keypress on each tick) </summary>
+		T p;
+		/// <summary> the kind of the keypresses </summary>
+		byte k;
+		T period() const
+		{
+			return p;
+		}
+		byte kind() const
+		{
+			return k;
+		}
+		bool step()
+		{
+			return false;
+		}
+	};
+
+	/// <summary> Fires the autorepeated keypresses due as the catch-up policy says and moves the schedule past them </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="held"> For how long the button has been held pressed </param>
+	/// <param name="delay"> For how long the button has to be held before the keypresses on this schedule start </param>
+	/// <param name="last"> The time the first keypress has been fired, then the tick before the last autorepeated 
+	/// keypress was due - updated when keypresses are due </param>
+	/// <param name="late"> Receives for how long the first of the keypresses has been due </param>
+	/// <param name="catchUp"> BUTTON_CATCHUP_SKIP, BUTTON_CATCHUP_BURST or BUTTON_CATCHUP_COUNT </param>
+	/// <param name="steps"> The schedule - period() before the next keypress, kind() of it and step() moving past it,
+	/// returning false once the period and the kind do not change any more (Steady, acceleration, curves) </param>
+	/// <param name="f"> Called with the kind and the number of keypresses each event stands for </param>
+	/// <returns> the number of keypresses fired (counted with BUTTON_CATCHUP_COUNT), 0 if none was due </returns>
+	/// <remarks> every deadline passed is stepped through (the ones on a period that no longer changes at once), so the
+	/// schedule ends in the same place whatever the policy and each keypress has the kind of its own step -
+	/// BURST fires them one by one, COUNT one event for each run of the same kind, SKIP only the last one </remarks>
+	template < class S, class F >
+	static unsigned int run(T now, T held, T delay, T &last, T &late, byte catchUp, S &steps, F &&f)
+	{
+		late = 0;
+		if (held <= delay)
+			return 0;
+		T period = steps.period();
+		T elapsed = (T)(now - last);
+		if (elapsed <= period)
+			return 0;
+		// on the schedule, but not before this period came into effect
+		late = (T)(elapsed - period - 1);
+		if ((T)(held - delay - 1) < late)
+			late = (T)(held - delay - 1);
+		T behind = late; // for how long the keypress being stepped over has been due
+		unsigned int n = 0, runCount = 0;
+		byte runKind = steps.kind();
+		auto take = [&](byte kind, unsigned int count)
+		{
+			n = add(n, count);
+			if (catchUp == BUTTON_CATCHUP_BURST)
+			{
+				while (count--)
+					f(kind, 1U);
+				return;
+			}
+			if (runCount && kind != runKind)
+			{
+				if (catchUp == BUTTON_CATCHUP_COUNT)
+					f(runKind, runCount);
+				runCount = 0;
+			}
+			runKind = kind;
+			runCount = add(runCount, count);
+		};
+		for (;;)
+		{
+			take(steps.kind(), 1);
+			bool changing = steps.step();
+			period = steps.period();
+			if (!changing) // the rest on the same period at once
+			{
+				if (period && behind >= period)
+				{
+					T missed = (T)(behind / period);
+					take(steps.kind(), missed < 0xFFFEU ? (unsigned int)missed : 0xFFFEU);
+					behind = (T)(behind % period);
+				}
+				break;
+			}
+			if (!period || behind < period)
+				break;
+			behind = (T)(behind - period);
+		}
+		if (catchUp == BUTTON_CATCHUP_COUNT)
+			f(runKind, runCount);
+		else if (catchUp != BUTTON_CATCHUP_BURST)
+		{
+			f(runKind, 1U);
+			n = 1;
+		}
+		if (period)
+			last = (T)(now - 1 - behind); // the tick before the last keypress was due
+		else
+			last = now; // once per tick
+		return n;
+	}
+
+private:
+	/// <summary> Adds the keypresses, saturating at 0xFFFF </summary>
+	static unsigned int add(unsigned int n, unsigned int count)
+	{
+		return 0xFFFFU - n < count ? 0xFFFFU : n + count;
+	}
 };
 
 /// <summary>
@@ -158,26 +907,94 @@ class PushButton
 /// adds autorepeat features and callback function to be called automatically when the button is pressedDebounced
 /// keeps track of the time the button has been held pressedDebounced
 /// </remarks>
-template < bool ACT = false >
-class PushButtonAutoRepeat : public PushButton<ACT>
+template < bool ACT = false, class HAL = YAPUSHBUTTON_DEFAULT_HAL, template < typename > class DEBOUNCER = PushButtonTimeWindow >
+class PushButtonAutoRepeat : public PushButton<ACT, HAL, DEBOUNCER>
 {
-	using PushButton<ACT>::debounceWaiting;
-	using PushButton<ACT>::singlePress;
-	using PushButton<ACT>::stateChangedTimeStamp;
-	using PushButton<ACT>::debounceDelay;
-	using PushButton<ACT>::previousButtonState;
+	using PushButton<ACT, HAL, DEBOUNCER>::debounceWaiting;
+	using PushButton<ACT, HAL, DEBOUNCER>::singlePress;
+	using PushButton<ACT, HAL, DEBOUNCER>::catchUp;
+	using PushButton<ACT, HAL, DEBOUNCER>::stateChangedTimeStamp;
+	using PushButton<ACT, HAL, DEBOUNCER>::debounceDelay;
+	using PushButton<ACT, HAL, DEBOUNCER>::previousButtonState;
+
+public:
+	/// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	typedef typename PushButton<ACT, HAL, DEBOUNCER>::time_type time_type;
 
 protected:
 	/// <summary> the delay before autorepeat begins </summary> 
-	unsigned long repeatDelay; 
+	time_type repeatDelay; 
 	/// <summary> the auto repeating period </summary> 
-	unsigned long repeatPeriod; 
-	/// <summary> the function to be called on each keypress event </summary> 
-	void(*keyPressCallback)();
+	time_type repeatPeriod; 
+	/// <summary> the function to be called on each keypress event with the context and the event (if set) </summary> 
+	void(*keyEventCallback)(void *context, ButtonEvent event);
+	union
+	{
+		/// <summary> the function to be called on each keypress event (if keyEventCallback is not set) </summary> 
+		void(*keyPressCallback)();
+		/// <summary> the context passed to keyEventCallback (only while keyEventCallback is set) </summary> 
+		void *callbackContext;
+	};
 
 	// operational
-	/// <summary> the time the last update was called in autorepeat </summary> 
-	unsigned long lastChangeTime; 
+	/// <summary> the time the first keypress has been fired, then the tick before the last autorepeated keypress was due </summary> 
+	time_type lastChangeTime; 
+	/// <summary> the number of keypresses autorepeated since the button has been pressed </summary> 
+	unsigned int repeatCount;
+
+	/// <summary> Makes the event for the next keypress and counts the repeats </summary>
+	/// <param name="kind"> BUTTON_EVENT_PRESS, BUTTON_EVENT_REPEAT or BUTTON_EVENT_ACCELERATED_REPEAT </param>
+	/// <param name="count"> The number of keypresses the event stands for </param>
+	/// <returns> the event to be reported </returns>
+	ButtonEvent nextEvent(byte kind, unsigned int count = 1)
+	{
+		if (kind == BUTTON_EVENT_PRESS)
+			repeatCount = 0;
+		else
+			repeatCount += count;
+		ButtonEvent e;
+		e.kind = kind;
+		e.repeatIndex = repeatCount;
+		e.count = count;
+		return e;
+	}
+
+	/// <summary> Fires the autorepeated keypresses due at the given period </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="period"> The autorepeat period in HAL ticks </param>
+	/// <param name="held"> For how long the button has been held pressed </param>
+	/// <param name="delay"> For how long the button has to be held before the keypresses at this period start </param>
+	/// <param name="kind"> BUTTON_EVENT_REPEAT or BUTTON_EVENT_ACCELERATED_REPEAT </param>
+	/// <param name="f"> Called with the events </param>
+	/// <returns> the number of keypresses fired (counted with BUTTON_CATCHUP_COUNT), 0 if none was due </returns>
+	/// <remarks> the keypresses are due on a fixed schedule (PushButtonRepeatSchedule) - every period from the first one, 
+	/// so a late call does not delay the following ones. If more than one is due the catch-up policy decides what is fired </remarks>
+	template < class F >
+	unsigned int repeatEvery(time_type now, time_type period, time_type held, time_type delay, byte kind, F &f)
+	{
+		typename PushButtonRepeatSchedule<time_type>::Steady steps = { period, kind };
+		return repeatOn(now, held, delay, steps, f);
+	}
+
+	/// <summary> Fires the autorepeated keypresses due on a schedule that may change with each keypress </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="held"> For how long the button has been held pressed </param>
+	/// <param name="delay"> For how long the button has to be held before the keypresses on this schedule start </param>
+	/// <param name="steps"> The schedule (see PushButtonRepeatSchedule::run()) </param>
+	/// <param name="f"> Called with the events </param>
+	/// <returns> the number of keypresses fired (counted with BUTTON_CATCHUP_COUNT), 0 if none was due </returns>
+	template < class S, class F >
+	unsigned int repeatOn(time_type now, time_type held, time_type delay, S &steps, F &f)
+	{
+		time_type late;
+		time_type period = steps.period();
+		bool first = !repeatCount;
+		unsigned int n = PushButtonRepeatSchedule<time_type>::run(now, held, delay, lastChangeTime, late, catchUp, steps,
+			[&](byte kind, unsigned int count) { f(nextEvent(kind, count)); });
+		if (n)
+			this->statsRepeat(now, period, late, first);
+		return n;
+	}
 
 public:
 	/// <summary> PushButtonAutoRepeat constructor </summary>
@@ -188,16 +1005,18 @@ public:
 	/// <param name="DebounceDelay"> The delay in milliseconds for debouncing </param>
 	PushButtonAutoRepeat(byte pbPin, void(*KeyPressCallBackFunction)() = NULL, 
 		unsigned long RepeatDelay = 500, unsigned long AutoRepeatingPeriod = 200, unsigned long DebounceDelay = 50) :
-		PushButton<ACT>(pbPin, DebounceDelay), keyPressCallback(KeyPressCallBackFunction), 
-		repeatDelay(RepeatDelay), repeatPeriod(AutoRepeatingPeriod)
+		PushButton<ACT, HAL, DEBOUNCER>(pbPin, DebounceDelay), repeatDelay(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(RepeatDelay)), 
+		repeatPeriod(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(AutoRepeatingPeriod)), keyEventCallback(NULL), keyPressCallback(KeyPressCallBackFunction), 
+		lastChangeTime(0), repeatCount(0)
 	{ 
 		singlePress = false;
+		catchUp = BUTTON_CATCHUP_SKIP;
 	}
 
 	/// <summary> initializes the PushButtonAutoRepeat object </summary>
 	void init()
 	{
-		PushButton<ACT>::init();
+		PushButton<ACT, HAL, DEBOUNCER>::init();
 		singlePress = false;
 	}
 
@@ -205,53 +1024,118 @@ public:
 	/// <param name="keyPressFunction"> The function to be called on each keypress </param>
 	void registerKeyPressCallback(void(*keyPressFunction)())
 	{
+		keyEventCallback = NULL;
 		keyPressCallback = keyPressFunction;
 	}
 
+	/// <summary> Registers the callback function to be called on each keypress with a context and the event </summary>
+	/// <param name="keyEventFunction"> The function to be called on each keypress </param>
+	/// <param name="context"> The pointer passed to the function (any user data - the value to change, an object ...) </param>
+	/// <remark> the same function can serve many buttons, each with its own context,
+	/// NULL for the function unregisters both callbacks </remark>
+	void registerKeyEventCallback(void(*keyEventFunction)(void *, ButtonEvent), void *context)
+	{
+		keyEventCallback = keyEventFunction;
+		if (keyEventFunction)
+			callbackContext = context;
+		else // the context shares the storage with keyPressCallback - it must not be left there to be called
+			keyPressCallback = NULL;
+	}
+
+	/// <summary> Calls the registered callback function </summary>
+	/// <param name="event"> The keypress to be reported </param>
+	void fire(ButtonEvent event)
+	{
+		if (keyEventCallback)
+			keyEventCallback(callbackContext, event);
+		else if (keyPressCallback)
+			keyPressCallback();
+	}
+
+	/// <summary> Functor calling the registered callback function (used by handle(now)) </summary>
+	struct Callback
+	{
+		PushButtonAutoRepeat *button;
+		void operator()(ButtonEvent event) const
+		{
+			button->fire(event);
+		}
+	};
+
 	/// <summary> Sets the delay the button has to be hold pressed before autorepeat starts </summary>
 	/// <param name="RepeatDelay"> The delay in milliseconds before autorepeat begins </param>
 	void setRepeatDelay(unsigned long RepeatDelay)
 	{
-		repeatDelay = RepeatDelay;
+		repeatDelay = this->delayTicks(RepeatDelay);
 	}
 
 	/// <summary> get the delay the button has to be hold pressed before autorepeat starts </summary>
 	/// <returns> The delay in milliseconds before autorepeat begins </returns>
 	unsigned long getRepeatDelay() const
 	{
-		return repeatDelay;
+		return HAL::toMillis(repeatDelay);
 	}
 	
 	/// <summary> Sets the period at which a new keypress will be automatically produced</summary>
 	/// <param name="AutoRepeatingPeriod"> The period in milliseconds at which a new keypress will be automatically produced </param>
 	void setRepeatPeriod(unsigned long AutoRepeatingPeriod)
 	{
-		repeatPeriod = AutoRepeatingPeriod;
+		repeatPeriod = this->delayTicks(AutoRepeatingPeriod);
 	}
 
 	/// <summary> Gets the period at which a new keypress will be automatically produced</summary>
 	/// <returns> The period in milliseconds at which a new keypress is automatically produced </returns>
 	unsigned long getRepeatPeriod() const
 	{
-		return repeatPeriod;
+		return HAL::toMillis(repeatPeriod);
+	}
+
+	/// <summary> Sets what is fired when handle() is called too late for more than one autorepeated keypress </summary>
+	/// <param name="policy"> BUTTON_CATCHUP_SKIP (default), BUTTON_CATCHUP_BURST or BUTTON_CATCHUP_COUNT </param>
+	/// <remarks> the keypresses are kept on schedule with any policy, SKIP drops the missed ones,
+	/// BURST fires them all at once, COUNT fires one event with the number of keypresses in ButtonEvent::count </remarks>
+	void setCatchUp(byte policy)
+	{
+		catchUp = policy;
+	}
+
+	/// <summary> Gets the catch-up policy </summary>
+	/// <returns> BUTTON_CATCHUP_SKIP, BUTTON_CATCHUP_BURST or BUTTON_CATCHUP_COUNT </returns>
+	byte getCatchUp() const
+	{
+		return catchUp;
 	}
 
 	/// <summary> For how long the button has been held pressed </summary>
-	/// <returns> the time in milliseconds the button is being held pressed </returns>
-	unsigned long heldDown()
+	/// <returns> the time in HAL ticks (milliseconds with the default HAL) the button is being held pressed </returns>
+	/// <remark> with compact (8 or 16 bit) time_type the duration saturates at half of its range </remark>
+	time_type heldDown()
+	{
+		return heldDown(HAL::now());
+	}
+
+	/// <summary> For how long the button has been held pressed at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> the time in HAL ticks the button is being held pressed </returns>
+	time_type heldDown(time_type now)
 	{
-		unsigned long r = 0UL;
+		time_type r = 0;
 		bool currentButtonState = this->isPressed();
+		this->statsSample(currentButtonState);
 
 		if (debounceWaiting) // are we waiting for the debounce period to pass?
 		{
-			unsigned long duration = millis() - stateChangedTimeStamp;
-			if (duration > debounceDelay) // been waiting long enough
+			this->bounceSample(now, currentButtonState);
+			time_type duration = (time_type)(now - stateChangedTimeStamp);
+			if (this->debounceSettled(now, currentButtonState, stateChangedTimeStamp, debounceDelay)) // been waiting long enough
 			{
 				if (!previousButtonState && currentButtonState) // was Up and is Down now (hass been pressed)
 					r = duration;
+				if (previousButtonState ^ currentButtonState)
+					this->statsReport(now, (previousButtonState << 1) | currentButtonState);
 				debounceWaiting = false;
 				previousButtonState = currentButtonState;
+				this->bounceLearn();
 			}
 		}
 		else // !debounceWaiting
@@ -259,12 +1143,14 @@ public:
 			if (previousButtonState ^ currentButtonState) // has just been pressed 
 			{
 				debounceWaiting = true; // mark that we are starting the wait to stabilize
-				stateChangedTimeStamp = millis(); // mark the time the state change was spotted
+				stateChangedTimeStamp = now; // mark the time the state change was spotted
+				this->debounceStart(now, currentButtonState);
+				this->bounceStart(currentButtonState);
 			}
 			else // no change in isPressed (either was and is up, or was and is down)
 			{
 				if (previousButtonState && currentButtonState) // was and still is down (beeing held pressed)
-					r = millis() - stateChangedTimeStamp;
+					r = PushButtonRepeatSchedule<time_type>::held(now, stateChangedTimeStamp);
 				else
 					previousButtonState = currentButtonState;
 			} 
@@ -279,24 +1165,71 @@ public:
 	/// for more than repeatDelay ms, autorepeat starts calling the function every repeatPeriod ms </remark> 
 	void handle()
 	{
-		unsigned long bpDur = heldDown(); // will return value > 0 if the button is pressed
+		handle(HAL::now());
+	}
+
+	/// <summary> Services auto repeating calls at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(time_type now)
+	{
+		Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Services auto repeating at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the ButtonEvent on each keypress instead of the callback </param>
+	/// <remark> the call of a functor or lambda can be inlined into handle() </remark>
+	template < class F >
+	void handle(time_type now, F &&f)
+	{
+		time_type bpDur = heldDown(now); // will return value > 0 if the button is pressed
 		if (!singlePress && bpDur) // > debounceDelay) // first notice of this keypress
 		{
-			keyPressCallback();
+			f(nextEvent(BUTTON_EVENT_PRESS));
 			singlePress = true;
-			lastChangeTime = millis();
-		}
-		if (bpDur > repeatDelay) // has been held pressed Debounced for more than repeatDelay ms
-		{
-			if (millis() - lastChangeTime > repeatPeriod) // if the period for repeating has passed, fire another press
-			{
-				keyPressCallback();
-				lastChangeTime = millis();
-			}
+			lastChangeTime = now;
 		}
+		// has been held pressed Debounced for more than repeatDelay ms and the period for repeating has passed - fire another press
+		repeatEvery(now, repeatPeriod, bpDur, repeatDelay, BUTTON_EVENT_REPEAT, f);
 		if (bpDur == 0) // button is released - reset isPressed
 			singlePress = false;
 	}
+
+	/// <summary> For how long the button has been held pressed (without reading the button) </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks the button has been held pressed, 0 if it is not </returns>
+	time_type heldFor(time_type now) const
+	{
+		if (debounceWaiting || !previousButtonState)
+			return 0;
+		return (time_type)(now - stateChangedTimeStamp);
+	}
+
+	/// <summary> The time until the next keypress would be fired at the given repeat period </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <param name="period"> The autorepeat period in HAL ticks </param>
+	/// <returns> the time in HAL ticks (0 if due), maxTime() if the button is not being held pressed </returns>
+	time_type nextRepeatIn(time_type now, time_type period) const
+	{
+		if (debounceWaiting || !previousButtonState) // waiting to stabilize or released
+			return PushButton<ACT, HAL, DEBOUNCER>::nextEventIn(now);
+		if (!singlePress) // the first keypress has not been fired yet
+			return 0;
+		time_type toDelay = this->untilElapsed(now, stateChangedTimeStamp, repeatDelay);
+		time_type toPeriod = this->untilElapsed(now, lastChangeTime, period);
+		return toDelay > toPeriod ? toDelay : toPeriod;
+	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until debounce expires or the next autorepeat keypress (0 if due), 
+	/// or maxTime() if only a press or release can produce the next event </returns>
+	/// <remark> handle() does not need to be called before that time unless the pin changes </remark>
+	time_type nextEventIn(time_type now) const
+	{
+		return nextRepeatIn(now, repeatPeriod);
+	}
 };
 
 /// <summary>
@@ -311,18 +1244,22 @@ public:
 /// adds autorepeat features and callback function to be called automatically when the button is pressedDebounced
 /// keeps track of the time the button has been held pressed
 /// </remarks>
-template < bool ACT = false >
-class PushButton2SpeedAutoRepeat : public PushButtonAutoRepeat<ACT>
+template < bool ACT = false, class HAL = YAPUSHBUTTON_DEFAULT_HAL, template < typename > class DEBOUNCER = PushButtonTimeWindow >
+class PushButton2SpeedAutoRepeat : public PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>
 {
-	using PushButtonAutoRepeat<ACT>::lastChangeTime;
-	using PushButtonAutoRepeat<ACT>::repeatDelay;
-	using PushButtonAutoRepeat<ACT>::repeatPeriod;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::lastChangeTime;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::repeatDelay;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::repeatPeriod;
+
+public:
+	/// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	typedef typename PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::time_type time_type;
 
 protected:
 	/// <summary> when hold down the delay before autorepeat changes to faster speed </summary> 
-	unsigned long repeatDelayAcc; // has to be greater than repeatDelay
+	time_type repeatDelayAcc; // has to be greater than repeatDelay
 	/// <summary> the period for faster auto repeating </summary> 
-	unsigned long repeatPeriodAcc;
+	time_type repeatPeriodAcc;
 
 public:
 	/// <summary> PushButton2SpeedAutoRepeat constructor </summary>
@@ -336,8 +1273,9 @@ public:
 	PushButton2SpeedAutoRepeat(byte pbPin, void(*KeyPressCallBackFunction)() = NULL,
 		unsigned long RepeatDelay = 500, unsigned long AutoRepeatingPeriod = 200,
 		unsigned long RepeatAccelerateDelay = 2000, unsigned long RepeatPeriodAcc = 50, unsigned long DebounceDelay = 50)
-		: PushButtonAutoRepeat<ACT>(pbPin, KeyPressCallBackFunction, RepeatDelay, AutoRepeatingPeriod, DebounceDelay),
-		repeatDelayAcc(RepeatAccelerateDelay), repeatPeriodAcc(RepeatPeriodAcc) 
+		: PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>(pbPin, KeyPressCallBackFunction, RepeatDelay, AutoRepeatingPeriod, DebounceDelay),
+		repeatDelayAcc(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(RepeatAccelerateDelay)), 
+		repeatPeriodAcc(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(RepeatPeriodAcc)) 
 	{ 
 #ifndef NDEBUG
 		assert(RepeatAccelerateDelay > RepeatDelay); 
@@ -348,7 +1286,7 @@ public:
 	/// <param name="RepeatAccelerateDelay"> The delay in milliseconds before accelerated autorepeat begins </param>
 	void setRepeatAccelerateDelay(unsigned long RepeatAccelerateDelay)
 	{
-		repeatDelayAcc = RepeatAccelerateDelay;
+		repeatDelayAcc = this->delayTicks(RepeatAccelerateDelay);
 #ifndef NDEBUG
 		assert(repeatDelayAcc > repeatDelay);
 #endif
@@ -358,21 +1296,21 @@ public:
 	/// <returns> The delay in milliseconds before accelerated autorepeat begins </returns>
 	unsigned long getRepeatAccelerateDelay() const
 	{
-		return repeatDelayAcc;
+		return HAL::toMillis(repeatDelayAcc);
 	}
 
 	/// <summary> Sets the period at which a new keypress will be automatically produced in accelerated speed </summary>
 	/// <param name="RepeatPeriodAcc"> The period in milliseconds at which a new keypress will be automatically produced in accelerated speed</param>
 	void setRepeatPeriodAcc(unsigned long RepeatPeriodAcc)
 	{
-		repeatPeriodAcc = RepeatPeriodAcc;
+		repeatPeriodAcc = this->delayTicks(RepeatPeriodAcc);
 	}
 
 	/// <summary> Gets the period at which a new keypress is automatically produced in accelerated speed </summary>
 	/// <returns> The period in milliseconds at which a new keypress is automatically produced in accelerated speed </returns>
 	unsigned long getRepeatPeriodAcc() const
 	{
-		return repeatPeriodAcc;
+		return HAL::toMillis(repeatPeriodAcc);
 	}
 
 	/// <summary> To be called repeatedly in a loop (services auto repeating calls) </summary>
@@ -383,36 +1321,63 @@ public:
 	/// after repeatDelayAcc milliseconds starts to autorepeat at faster speed </remark> 
 	void handle()
 	{
-		unsigned long bpDur = this->heldDown();
-		if (!this->getSinglePress() && bpDur> this->getDebounceDelay())
+		handle(HAL::now());
+	}
+
+	/// <summary> Services auto repeating calls at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(time_type now)
+	{
+		typename PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Services auto repeating at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the ButtonEvent on each keypress instead of the callback </param>
+	/// <remark> the keypresses at faster speed are reported as BUTTON_EVENT_ACCELERATED_REPEAT </remark>
+	template < class F >
+	void handle(time_type now, F &&f)
+	{
+		time_type bpDur = this->heldDown(now);
+		if (!this->getSinglePress() && bpDur > HAL::toTicks(this->getDebounceDelay()))
 		{
-			this->keyPressCallback();
+			f(this->nextEvent(BUTTON_EVENT_PRESS));
 			this->setSinglePress(true);
-			lastChangeTime = millis();
+			lastChangeTime = now;
 		}
-		if (bpDur > repeatDelay)
+		if (bpDur > repeatDelayAcc)
 		{
-			unsigned long now = millis();
-			if (bpDur > repeatDelayAcc)
-			{
-				if (now - lastChangeTime > repeatPeriodAcc)
-				{
-					this->keyPressCallback();
-					lastChangeTime = now;
-				}
-			}
-			else
-			{
-				if (now - lastChangeTime > repeatPeriod)
-				{
-					this->keyPressCallback();
-					lastChangeTime = now;
-				}
-			}
+			time_type pastAcc = (time_type)(bpDur - repeatDelayAcc);
+			if ((time_type)(now - lastChangeTime) > pastAcc) // the keypresses at slow speed due until the switch (a late call)
+				this->repeatEvery((time_type)(now - pastAcc), repeatPeriod, repeatDelayAcc, repeatDelay, BUTTON_EVENT_REPEAT, f);
+			this->repeatEvery(now, repeatPeriodAcc, bpDur, repeatDelayAcc, BUTTON_EVENT_ACCELERATED_REPEAT, f);
 		}
+		else
+			this->repeatEvery(now, repeatPeriod, bpDur, repeatDelay, BUTTON_EVENT_REPEAT, f);
 		if (bpDur == 0)
 			this->setSinglePress(false);
 	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until debounce expires or the next autorepeat keypress (0 if due), 
+	/// or maxTime() if only a press or release can produce the next event </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		time_type held = this->heldFor(now);
+		if (held > repeatDelayAcc) // already at faster speed
+			return this->nextRepeatIn(now, repeatPeriodAcc);
+		time_type slow = this->nextRepeatIn(now, repeatPeriod);
+		if (!held)
+			return slow;
+		// may switch to faster speed before the next keypress at slow speed
+		time_type toAcc = (time_type)(repeatDelayAcc - held + 1);
+		time_type fast = this->nextRepeatIn(now, repeatPeriodAcc);
+		if (fast < toAcc)
+			fast = toAcc;
+		return fast < slow ? fast : slow;
+	}
 };
 
 /// <summary>
@@ -428,22 +1393,47 @@ public:
 /// keeps track of the time the button has been held pressed
 /// </remarks>
 // adds acceleration (faster repeat rate) as the button is being held pressed longer
-template < bool ACT = false >
-class PushButtonAutoAcceleratedRepeat : public PushButtonAutoRepeat<ACT>
+template < bool ACT = false, class HAL = YAPUSHBUTTON_DEFAULT_HAL, template < typename > class DEBOUNCER = PushButtonTimeWindow >
+class PushButtonAutoAcceleratedRepeat : public PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>
 {
-	using PushButtonAutoRepeat<ACT>::lastChangeTime;
-	using PushButtonAutoRepeat<ACT>::repeatDelay;
-	using PushButtonAutoRepeat<ACT>::repeatPeriod;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::lastChangeTime;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::repeatDelay;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::repeatPeriod;
+
+public:
+	/// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	typedef typename PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::time_type time_type;
 
 protected:
 	/// <summary> when held down the delay before autorepeat starts to accelerate </summary> 
-	unsigned long repeatDelayAcc; 
+	time_type repeatDelayAcc; 
 	/// <summary> the acceleration factor </summary> 
-	unsigned long repeatAcc; 
+	time_type repeatAcc; 
 	/// <summary> minimum period below which it will not accelerate </summary> 
-	unsigned long repeatMinPeriod; 
+	time_type repeatMinPeriod; 
 	/// <summary> the current period for autorepeat </summary> 
-	unsigned long currentRepeatPeriod; 
+	time_type currentRepeatPeriod; 
+
+	/// <summary> The accelerating schedule - the period is shortened after each keypress due (PushButtonRepeatSchedule::run()) </summary>
+	struct Steps
+	{
+		PushButtonAutoAcceleratedRepeat *button;
+		time_type period() const
+		{
+			return (time_type)(button->currentRepeatPeriod + button->repeatMinPeriod);
+		}
+		byte kind() const
+		{
+			return button->currentRepeatPeriod < button->repeatPeriod ? BUTTON_EVENT_ACCELERATED_REPEAT : BUTTON_EVENT_REPEAT;
+		}
+		bool step()
+		{
+			if (!button->repeatAcc || button->currentRepeatPeriod < button->repeatAcc) // no longer accelerating
+				return false;
+			button->currentRepeatPeriod -= button->repeatAcc;
+			return true;
+		}
+	};
 
 public:
 	/// <summary> PushButtonAutoAcceleratedRepeat constructor </summary>
@@ -459,12 +1449,14 @@ public:
 		unsigned long RepeatDelay = 500, unsigned long AutoRepeatingPeriod = 200, 
 		unsigned long RepeatDelayAcc = 2000, unsigned long RepeatAcc = 10, 
 		unsigned long repeatMinPeriod = 20, unsigned long DebounceDelay = 50)
-		: PushButtonAutoRepeat<ACT>(pbPin, KeyPressCallBackFunction, RepeatDelay,
-			AutoRepeatingPeriod, DebounceDelay), repeatDelayAcc(RepeatDelayAcc), 
-			repeatAcc(RepeatAcc), repeatMinPeriod(repeatMinPeriod) 
+		: PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>(pbPin, KeyPressCallBackFunction, RepeatDelay,
+			AutoRepeatingPeriod, DebounceDelay), repeatDelayAcc(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(RepeatDelayAcc)), 
+			repeatAcc(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(RepeatAcc)), repeatMinPeriod(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(repeatMinPeriod)), 
+			currentRepeatPeriod(PushButton<ACT, HAL, DEBOUNCER>::delayTicks(AutoRepeatingPeriod))
 	{ 
 #ifndef NDEBUG
 		assert(repeatDelayAcc > repeatDelay);
+		assert(AutoRepeatingPeriod + repeatMinPeriod <= this->maxDelay());
 #endif
 	}
 
@@ -472,7 +1464,7 @@ public:
 	/// <param name="RepeatDelayAcc"> The delay in milliseconds before accelerated autorepeat begins </param>
 	void setRepeatAccelerateDelay(unsigned long RepeatDelayAcc)
 	{
-		repeatDelayAcc = RepeatDelayAcc;
+		repeatDelayAcc = this->delayTicks(RepeatDelayAcc);
 #ifndef NDEBUG
 		assert(repeatDelayAcc > repeatDelay);
 #endif
@@ -482,35 +1474,35 @@ public:
 	/// <returns> The delay in milliseconds before accelerated autorepeat begins </returns>
 	unsigned long getRepeatAccelerateDelay() const
 	{
-		return repeatDelayAcc;
+		return HAL::toMillis(repeatDelayAcc);
 	}
 
 	/// <summary> Sets the acceleration rate </summary>
 	/// <param name="RepeatAcc"> The decrement in milliseconds at which the delay befor the automatically produced kepresses will be generated</param>
 	void setRepeatAcc(unsigned long RepeatAcc)
 	{
-		repeatAcc = RepeatAcc;
+		repeatAcc = this->delayTicks(RepeatAcc);
 	}
 
 	/// <summary> Gets the acceleration rate </summary>
 	/// <returns> The acceleration (in milliseconds decremented in each step) </returns>
 	unsigned long getRepeatAcc() const
 	{
-		return repeatAcc;
+		return HAL::toMillis(repeatAcc);
 	}
 
 	/// <summary> Sets the minimum period at which a new keypress will be automatically produced in accelerated speed (determines maximum speed of autorepeat) </summary>
 	/// <param name="RepeatMinPeriod"> The period in milliseconds at which a new keypress will be automatically produced in accelerated speed</param>
 	void setRepeatMinPeriod(unsigned long RepeatMinPeriod)
 	{
-		repeatMinPeriod = RepeatMinPeriod;
+		repeatMinPeriod = this->delayTicks(RepeatMinPeriod);
 	}
 
 	/// <summary> Gets the period at which a new keypress is automatically produced in accelerated speed </summary>
 	/// <returns> The period in milliseconds at which a new keypress is automatically produced in accelerated speed </returns>
 	unsigned long getRepeatMinPeriod() const
 	{
-		return repeatMinPeriod;
+		return HAL::toMillis(repeatMinPeriod);
 	}
 
 	/// <summary> To be called repeatedly in a loop (services auto repeating calls) </summary>
@@ -521,28 +1513,46 @@ public:
 	/// after configured milliseconds starts to accelerate autorepeat at given factor </remark> 
 	void handle()
 	{
-		unsigned long bpDur = this->heldDown();
-		if (!this->getSinglePress() && bpDur > this->getDebounceDelay())
+		handle(HAL::now());
+	}
+
+	/// <summary> Services auto repeating calls at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(time_type now)
+	{
+		typename PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Services auto repeating at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the ButtonEvent on each keypress instead of the callback </param>
+	/// <remark> the keypresses after the period has started to shorten are reported as BUTTON_EVENT_ACCELERATED_REPEAT </remark>
+	template < class F >
+	void handle(time_type now, F &&f)
+	{
+		time_type bpDur = this->heldDown(now);
+		if (!this->getSinglePress() && bpDur > HAL::toTicks(this->getDebounceDelay()))
 		{
-			this->keyPressCallback();
+			f(this->nextEvent(BUTTON_EVENT_PRESS));
 			this->setSinglePress(true);
-			lastChangeTime = millis();
+			lastChangeTime = now;
 			currentRepeatPeriod = repeatPeriod;
 		}
-		if (bpDur > repeatDelay)
-		{
-			unsigned long now = millis();
-			if (now - lastChangeTime > currentRepeatPeriod + repeatMinPeriod)
-			{
-				if (currentRepeatPeriod>= repeatAcc)
-					currentRepeatPeriod-= repeatAcc;
-				this->keyPressCallback();
-				lastChangeTime = now;
-			}
-		}
+		Steps steps = { this };
+		this->repeatOn(now, bpDur, repeatDelay, steps, f);
 		if (bpDur == 0)
 			this->setSinglePress(false);
 	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until debounce expires or the next autorepeat keypress (0 if due), 
+	/// or maxTime() if only a press or release can produce the next event </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		return this->nextRepeatIn(now, (time_type)(currentRepeatPeriod + repeatMinPeriod));
+	}
 };
 
 #endif
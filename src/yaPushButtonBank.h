@@ -0,0 +1,171 @@
+// yaPushButtonBank.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// debounces a whole bank of buttons (up to 8, 16 or 32) sampled with a single port read
+// uses 2-bit vertical counters, so all the buttons in the bank are debounced in parallel
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONBANK_h
+#define _YAPUSHBUTTONBANK_h
+
+#include "yaPushButton.h"
+
+/// <summary>
+/// PushButtonBank Template Class
+/// </summary>
+/// <remarks>
+/// Implements debouncing of up to 8 * sizeof(T) push buttons read all at once
+/// T is the type of the port word (byte, uint16_t or uint32_t), one bit per button
+/// The port is read through a user supplied function (for example returning PIND or ~PINB)
+/// Each bit has its own 2-bit vertical counter - the debounced state of a button changes
+/// only after 4 consecutive samples differing from it, samples are taken every samplePeriod ms
+/// so a state change is reported 4 * samplePeriod ms after the button has settled
+/// The scan cost does not depend on the number of buttons in the bank
+/// </remarks>
+template < typename T = byte, class HAL = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonBank
+{
+protected:
+// configuration
+	/// <summary> the function that reads the raw state of the port (all the buttons at once) </summary>
+	T(*readPort)();
+	/// <summary> bit set to 1 marks active high button, 0 active low button (connects to GND when pressed) </summary>
+	T activeHighMask;
+	/// <summary> the time between two samples of the port (in HAL ticks) </summary>
+	typename HAL::time_type samplePeriod;
+
+// operation
+	/// <summary> the time the port was last sampled </summary>
+	typename HAL::time_type lastSampleTime;
+	/// <summary> the debounced state of the buttons (bit set while the button is pressed) </summary>
+	T debouncedState;
+	/// <summary> low bits of the vertical counters </summary>
+	T counter0;
+	/// <summary> high bits of the vertical counters </summary>
+	T counter1;
+	/// <summary> the buttons whose debounced state changed on the last sample </summary>
+	T changedMask;
+
+public:
+	/// <summary> PushButtonBank constructor </summary>
+	/// <param name="PortReadFunction"> The function returning the raw state of all the buttons in the bank </param>
+	/// <param name="ActiveHighMask"> Bit set to 1 marks active high button, 0 marks active low button </param>
+	/// <param name="SamplePeriod"> The period in milliseconds between samples, debounce delay is 4 * SamplePeriod </param>
+	PushButtonBank(T(*PortReadFunction)(), T ActiveHighMask = 0, unsigned long SamplePeriod = 12) :
+		readPort(PortReadFunction), activeHighMask(ActiveHighMask), samplePeriod(PushButton<false, HAL>::delayTicks(SamplePeriod))
+	{
+		init();
+	}
+
+	/// <summary> initializes the PushButtonBank object (all buttons released) </summary>
+	/// <remarks> configuring the pins (or the whole port) as inputs is left to the caller </remarks>
+	void init()
+	{
+		debouncedState = 0; // none pressed
+		counter0 = counter1 = (T)~(T)0; // counters reset (count down from 3)
+		changedMask = 0;
+		lastSampleTime = HAL::now();
+	}
+
+	/// <summary> Sets the sampling period </summary>
+	/// <param name="SamplePeriod"> The period in milliseconds between samples, debounce delay is 4 * SamplePeriod </param>
+	void setSamplePeriod(unsigned long SamplePeriod)
+	{
+		samplePeriod = PushButton<false, HAL>::delayTicks(SamplePeriod);
+	}
+
+	/// <summary> Gets the sampling period </summary>
+	/// <returns> the period in milliseconds between samples </returns>
+	unsigned long getSamplePeriod() const
+	{
+		return HAL::toMillis(samplePeriod);
+	}
+
+	/// <summary> Reads the raw (not debounced) state of the buttons </summary>
+	/// <returns> bitmask with bit set for each button being pressed in the moment </returns>
+	T readRaw()
+	{
+		// active low buttons read 0 when pressed
+		return (T)(readPort() ^ (T)~activeHighMask);
+	}
+
+	/// <summary> Samples the port and debounces all the buttons </summary>
+	/// <returns> bitmask of the buttons whose debounced state has changed (0 if nothing changed or it was not time to sample yet) </returns>
+	/// <remark> To be called repeatedly in a loop, the port is read only once every samplePeriod ms </remark>
+	T scan()
+	{
+		return scan(HAL::now());
+	}
+
+	/// <summary> Samples the port and debounces all the buttons at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> bitmask of the buttons whose debounced state has changed </returns>
+	T scan(typename HAL::time_type now)
+	{
+		changedMask = 0;
+		if ((typename HAL::time_type)(now - lastSampleTime) < samplePeriod) // not yet time for next sample
+			return 0;
+		lastSampleTime = now;
+
+		T delta = (T)(readRaw() ^ debouncedState); // bits that differ from debounced state
+		counter0 = (T)~(counter0 & delta); // counters of unchanged bits are reset to 3
+		counter1 = (T)(counter0 ^ (counter1 & delta)); // others count down
+		changedMask = (T)(delta & counter0 & counter1); // rolled over from 0 to 3 - differed for 4 samples
+		debouncedState ^= changedMask;
+		return changedMask;
+	}
+
+	/// <summary> The buttons that have been pressed on the last scan </summary>
+	/// <returns> bitmask with bit set for each button that has just been pressed </returns>
+	T pressed() const
+	{
+		return changedMask & debouncedState;
+	}
+
+	/// <summary> The buttons that have been released on the last scan </summary>
+	/// <returns> bitmask with bit set for each button that has just been released </returns>
+	T released() const
+	{
+		return changedMask & (T)~debouncedState;
+	}
+
+	/// <summary> The debounced state of all the buttons </summary>
+	/// <returns> bitmask with bit set for each button being (held) pressed </returns>
+	T state() const
+	{
+		return debouncedState;
+	}
+
+	/// <summary> Is the button (held) pressed or not (debounced) </summary>
+	/// <param name="bit"> The bit of the port the button is connected to </param>
+	/// <returns> true if the button is pressed </returns>
+	bool isPressed(byte bit) const
+	{
+		return (debouncedState >> bit) & 1;
+	}
+
+	/// <summary> State change of a single button on the last scan </summary>
+	/// <param name="bit"> The bit of the port the button is connected to </param>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	byte stateChanged(byte bit) const
+	{
+		if (!((changedMask >> bit) & 1))
+			return BUTTON_NOCHANGE;
+		return isPressed(bit) ? BUTTON_PRESSED : BUTTON_RELEASED;
+	}
+
+	/// <summary> The time until the next sample that can change the debounced state </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until the next sample (0 if due) while any of the buttons is 
+	/// being debounced, or the maximum value of the time type if all the buttons are stable </returns>
+	/// <remark> when all the counters are reset only a change of the port can start a new count </remark>
+	typename HAL::time_type nextEventIn(typename HAL::time_type now) const
+	{
+		typedef typename HAL::time_type time_type;
+		if ((T)(counter0 & counter1) == (T)~(T)0) // no counter running
+			return (time_type)~(time_type)0;
+		time_type elapsed = (time_type)(now - lastSampleTime);
+		return elapsed >= samplePeriod ? 0 : (time_type)(samplePeriod - elapsed);
+	}
+};
+
+#endif
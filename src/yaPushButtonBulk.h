@@ -0,0 +1,322 @@
+// yaPushButtonBulk.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// buttons behind 74HC165 shift register chains and I2C port expanders - the whole chain
+// or port is read once per scan into a cached bitmap that all the buttons read their pins from
+// (the transfer is split in begin() and finish(), only the SPI hardware shifts in between - the first byte
+// of the chain while the buttons are processed, the bit-banged chain and the I2C expanders are read synchronously)
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONBULK_h
+#define _YAPUSHBUTTONBULK_h
+
+#include "yaPushButton.h"
+
+/// <summary> Selects the unsigned type with a bit for each input of BYTES bytes (1 to 4) </summary>
+template < byte BYTES >
+struct PushButtonBulkWord
+{
+	typedef uint32_t type;
+};
+template < >
+struct PushButtonBulkWord<1>
+{
+	typedef byte type;
+};
+template < >
+struct PushButtonBulkWord<2>
+{
+	typedef uint16_t type;
+};
+
+/// <summary>
+/// PushButtonBulkHAL Template Class
+/// </summary>
+/// <remarks>
+/// Hardware access policy reading the pins from a cached bitmap of all the inputs of a DEVICE
+/// (a shift register chain, a port expander ...), the time comes from the BASE policy
+/// update() (once per scan, before the buttons are serviced) takes the inputs of the transfer
+/// begun on the previous update() and begins the next one - the buttons see the inputs as they were
+/// latched on the previous update(). What runs between the two calls depends on the DEVICE:
+/// PushButtonShiftInSPI shifts the first byte in hardware while the buttons are processed,
+/// PushButtonShiftIn only latches the inputs in begin() and bit-bangs all of them in finish(),
+/// PushButtonPCF857x does the whole (blocking) I2C read in begin() - for these update() takes
+/// the full transfer time, the saving is one transfer per scan instead of one per button
+/// The pin of a button is the bit of its input in the bitmap, the inputs need no configuration
+/// A DEVICE is a class with the static functions:
+///   setup() - configures the bus, begin() - starts a transfer (latches the inputs),
+///   word_type finish() - waits for the transfer and returns the inputs (bit set for HIGH)
+/// Each DEVICE type has its own bitmap
+/// </remarks>
+template < class DEVICE, class BASE = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonBulkHAL : public BASE
+{
+public:
+	/// <summary> the type of the bitmap of the inputs </summary>
+	typedef typename DEVICE::word_type word_type;
+
+	/// <summary> Sets up the device and starts the first transfer </summary>
+	/// <remark> to be called once, before the buttons are initialized </remark>
+	static void begin()
+	{
+		DEVICE::setup();
+		DEVICE::begin();
+		bits() = DEVICE::finish();
+		DEVICE::begin();
+	}
+
+	/// <summary> Takes the inputs of the transfer in progress into the bitmap and starts the next transfer </summary>
+	/// <remark> to be called once per scan, before the buttons are serviced </remark>
+	static void update()
+	{
+		bits() = DEVICE::finish();
+		DEVICE::begin();
+	}
+
+	/// <summary> The bitmap of the inputs taken by the last update() </summary>
+	/// <returns> bit set for each input at HIGH level </returns>
+	static word_type inputs()
+	{
+		return bits();
+	}
+
+	/// <summary> Reads the pin from the bitmap </summary>
+	/// <param name="pin"> The bit of the input </param>
+	/// <returns> HIGH or LOW </returns>
+	static int readPin(byte pin)
+	{
+		return (bits() >> pin) & 1 ? HIGH : LOW;
+	}
+
+	/// <summary> The inputs of the device need no configuration </summary>
+	static void setupPin(byte, byte)
+	{ }
+
+private:
+	static word_type &bits()
+	{
+		static word_type b = (word_type)~(word_type)0; // released active low buttons until the first update
+		return b;
+	}
+};
+
+/// <summary>
+/// PushButtonShiftIn Template Class
+/// </summary>
+/// <remarks>
+/// Chain of BYTES 74HC165 shift registers read by bit-banging through the HAL - LOAD to SH/LD, CLK to CLK
+/// and DATA to QH of the first register (CLK INH tied LOW). begin() only latches the inputs, finish()
+/// shifts all 8*BYTES bits in synchronously - nothing of the transfer overlaps the processing of the buttons
+/// Input n of register i (the one at the MCU first) is bit 8*i + n of the bitmap
+/// </remarks>
+template < byte LOAD, byte CLK, byte DATA, byte BYTES = 1, class HAL = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonShiftIn
+{
+	static_assert(BYTES >= 1 && BYTES <= 4, "PushButtonShiftIn supports chains of up to 4 registers");
+
+public:
+	/// <summary> the type of the bitmap of the inputs </summary>
+	typedef typename PushButtonBulkWord<BYTES>::type word_type;
+
+	/// <summary> Configures the pins </summary>
+	static void setup()
+	{
+		HAL::writePin(LOAD, HIGH);
+		HAL::writePin(CLK, LOW);
+		HAL::setupPin(LOAD, OUTPUT);
+		HAL::setupPin(CLK, OUTPUT);
+		HAL::setupPin(DATA, INPUT);
+	}
+
+	/// <summary> Latches the inputs into the registers </summary>
+	static void begin()
+	{
+		HAL::writePin(LOAD, LOW);
+		HAL::writePin(LOAD, HIGH);
+	}
+
+	/// <summary> Shifts the latched inputs in (blocking, 8*BYTES clock pulses) </summary>
+	/// <returns> the inputs (bit set for HIGH) </returns>
+	static word_type finish()
+	{
+		word_type r = 0;
+		for (byte i = 0; i < BYTES; i++)
+			for (byte n = 8; n--; ) // input H comes first
+			{
+				if (HAL::readPin(DATA))
+					r |= (word_type)1 << (8 * i + n);
+				HAL::writePin(CLK, HIGH);
+				HAL::writePin(CLK, LOW);
+			}
+		return r;
+	}
+};
+
+#ifndef YAPUSHBUTTON_HOST
+#if defined(__AVR__) && defined(SPDR)
+/// <summary>
+/// PushButtonShiftInSPI Template Class
+/// </summary>
+/// <remarks>
+/// Chain of BYTES 74HC165 shift registers read by the SPI hardware of AVR - LOAD to SH/LD, SCK to CLK, MISO to QH
+/// of the first register. begin() latches the inputs and starts shifting the first byte, which the hardware
+/// does while the buttons are processed, finish() waits for it and shifts the rest synchronously (by polling)
+/// - only the first byte of a longer chain overlaps the processing of the buttons
+/// The SPI has to be set up by the sketch (SPI.begin(), mode 0, MSB first) and not be used between update() calls
+/// Input n of register i (the one at the MCU first) is bit 8*i + n of the bitmap
+/// </remarks>
+template < byte LOAD, byte BYTES = 1 >
+class PushButtonShiftInSPI
+{
+	static_assert(BYTES >= 1 && BYTES <= 4, "PushButtonShiftInSPI supports chains of up to 4 registers");
+
+public:
+	/// <summary> the type of the bitmap of the inputs </summary>
+	typedef typename PushButtonBulkWord<BYTES>::type word_type;
+
+	/// <summary> Configures the LOAD pin </summary>
+	static void setup()
+	{
+		pinMode(LOAD, OUTPUT);
+		digitalWrite(LOAD, HIGH);
+	}
+
+	/// <summary> Latches the inputs and starts shifting the first byte </summary>
+	static void begin()
+	{
+		digitalWrite(LOAD, LOW);
+		digitalWrite(LOAD, HIGH);
+		SPDR = 0;
+	}
+
+	/// <summary> Waits for the first byte and shifts the rest in </summary>
+	/// <returns> the inputs (bit set for HIGH) </returns>
+	static word_type finish()
+	{
+		word_type r = 0;
+		for (byte i = 0; i < BYTES; i++)
+		{
+			while (!(SPSR & _BV(SPIF)))
+				;
+			r |= (word_type)SPDR << (8 * i);
+			if (i + 1 < BYTES)
+				SPDR = 0;
+		}
+		return r;
+	}
+};
+#endif
+
+#ifdef YAPUSHBUTTON_PCF857X
+#include <Wire.h>
+
+/// <summary>
+/// PushButtonPCF857x Template Class
+/// </summary>
+/// <remarks>
+/// PCF8574 (BYTES = 1) or PCF8575 (BYTES = 2) I2C port expander at address ADDR
+/// (available with #define YAPUSHBUTTON_PCF857X before including yaPushButtonBulk.h, Wire.begin() is left to the sketch)
+/// begin() does the whole read of the port into the Wire buffer - Wire transfers are blocking, so nothing
+/// overlaps the processing of the buttons, finish() only takes the bytes from the buffer
+/// All the pins are inputs (the expander outputs are left HIGH - weak pull-up)
+/// </remarks>
+template < byte ADDR, byte BYTES = 1 >
+class PushButtonPCF857x
+{
+	static_assert(BYTES == 1 || BYTES == 2, "PushButtonPCF857x supports 8 and 16 bit expanders");
+
+public:
+	/// <summary> the type of the bitmap of the inputs </summary>
+	typedef typename PushButtonBulkWord<BYTES>::type word_type;
+
+	/// <summary> Sets all the pins HIGH (inputs) </summary>
+	static void setup()
+	{
+		Wire.beginTransmission(ADDR);
+		for (byte i = 0; i < BYTES; i++)
+			Wire.write((byte)0xFF);
+		Wire.endTransmission();
+	}
+
+	/// <summary> Reads the port </summary>
+	static void begin()
+	{
+		Wire.requestFrom(ADDR, BYTES);
+	}
+
+	/// <summary> Takes the port from the Wire buffer </summary>
+	/// <returns> the inputs (bit set for HIGH), all HIGH if the expander did not answer </returns>
+	static word_type finish()
+	{
+		if (Wire.available() < BYTES)
+			return (word_type)~(word_type)0;
+		word_type r = 0;
+		for (byte i = 0; i < BYTES; i++)
+			r |= (word_type)Wire.read() << (8 * i);
+		return r;
+	}
+};
+#endif
+#else
+/// <summary>
+/// PushButtonHostDevice Template Class
+/// </summary>
+/// <remarks>
+/// Mock of a bulk input device for host builds - the inputs are the simulated pins FIRST .. FIRST + 8*BYTES - 1
+/// of PushButtonHostHAL (set directly or following waveforms), latched by begin() at the time of the virtual clock
+/// Counts the transfers, so the tests can check that the device is read once per scan
+/// </remarks>
+template < byte FIRST = 0, byte BYTES = 1 >
+class PushButtonHostDevice
+{
+public:
+	/// <summary> the type of the bitmap of the inputs </summary>
+	typedef typename PushButtonBulkWord<BYTES>::type word_type;
+
+	static void setup()
+	{ }
+
+	/// <summary> Latches the simulated pins </summary>
+	static void begin()
+	{
+		word_type r = 0;
+		for (byte i = 0; i < 8 * BYTES; i++)
+			if (PushButtonHostHAL::readPin(FIRST + i))
+				r |= (word_type)1 << i;
+		latched() = r;
+		transferCount()++;
+	}
+
+	/// <summary> Returns the latched pins </summary>
+	static word_type finish()
+	{
+		return latched();
+	}
+
+	/// <summary> The number of transfers since the last resetTransfers() </summary>
+	static unsigned long transfers()
+	{
+		return transferCount();
+	}
+
+	/// <summary> Resets the counter of the transfers </summary>
+	static void resetTransfers()
+	{
+		transferCount() = 0;
+	}
+
+private:
+	static word_type &latched()
+	{
+		static word_type b = (word_type)~(word_type)0;
+		return b;
+	}
+
+	static unsigned long &transferCount()
+	{
+		static unsigned long n = 0;
+		return n;
+	}
+};
+#endif
+
+#endif
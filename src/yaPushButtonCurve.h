@@ -0,0 +1,278 @@
+// yaPushButtonCurve.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// autorepeat following an arbitrary acceleration curve - the repeat periods are read
+// from a lookup table (in program memory on AVR), one entry further on each keypress
+// the tables can be written by hand (stepped curves) or generated at compile time
+// from the exponential, linear and S-shaped curves below
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONCURVE_h
+#define _YAPUSHBUTTONCURVE_h
+
+#include "yaPushButton.h"
+
+// the curve tables are kept in program memory on AVR (declare them with YAPUSHBUTTON_PROGMEM)
+#if defined(__AVR__) && !defined(YAPUSHBUTTON_HOST)
+#include <avr/pgmspace.h>
+#define YAPUSHBUTTON_PROGMEM PROGMEM
+#else
+#define YAPUSHBUTTON_PROGMEM
+#endif
+
+/// <summary> Exponential curve - each period is PERCENT % shorter than the previous one, down to TO </summary>
+/// <remarks> the periods (FROM, TO) in milliseconds </remarks>
+template < uint16_t FROM, uint16_t TO, byte PERCENT >
+struct PushButtonExponentialCurve
+{
+	static_assert(PERCENT > 0 && PERCENT < 100, "PERCENT has to be between 1 and 99");
+
+	/// <summary> The period p shortened by PERCENT % (not below TO) </summary>
+	static constexpr uint16_t shorten(uint16_t p)
+	{
+		return (uint32_t)p * (100 - PERCENT) / 100 > TO ? (uint16_t)((uint32_t)p * (100 - PERCENT) / 100) : TO;
+	}
+
+	/// <summary> The period after the keypress i + 1 </summary>
+	static constexpr uint16_t period(unsigned int i)
+	{
+		return i == 0 ? FROM : shorten(period(i - 1));
+	}
+};
+
+/// <summary> Linear curve - each period is STEP milliseconds shorter than the previous one, down to TO </summary>
+/// <remarks> the periods (FROM, TO) in milliseconds (what PushButtonAutoAcceleratedRepeat does) </remarks>
+template < uint16_t FROM, uint16_t TO, uint16_t STEP >
+struct PushButtonLinearCurve
+{
+	/// <summary> The period after the keypress i + 1 </summary>
+	static constexpr uint16_t period(unsigned int i)
+	{
+		return (uint32_t)STEP * i + TO < FROM ? (uint16_t)(FROM - (uint32_t)STEP * i) : TO;
+	}
+};
+
+/// <summary> S-shaped curve - starts and ends slowly, the fastest change is in the middle, reaches TO after STEPS keypresses </summary>
+/// <remarks> the periods (FROM, TO) in milliseconds (smoothstep 3x^2 - 2x^3 in integers) </remarks>
+template < uint16_t FROM, uint16_t TO, byte STEPS >
+struct PushButtonSCurve
+{
+	static_assert(FROM >= TO && STEPS > 0, "PushButtonSCurve goes from the longer period FROM to the shorter TO in STEPS keypresses");
+
+	/// <summary> The period after the keypress i + 1 </summary>
+	static constexpr uint16_t period(unsigned int i)
+	{
+		return i >= STEPS ? TO : (uint16_t)(FROM - (unsigned long long)(FROM - TO) *
+			(3ULL * i * i * STEPS - 2ULL * i * i * i) / ((unsigned long long)STEPS * STEPS * STEPS));
+	}
+};
+
+/// <summary> Index list for generating the tables </summary>
+template < unsigned int... I >
+struct PushButtonCurveIndices
+{ };
+
+/// <summary> Builds the index list 0 .. N-1 </summary>
+template < unsigned int N, unsigned int... I >
+struct PushButtonCurveBuild : PushButtonCurveBuild<N - 1, N - 1, I...>
+{ };
+template < unsigned int... I >
+struct PushButtonCurveBuild<0, I...>
+{
+	typedef PushButtonCurveIndices<I...> type;
+};
+
+/// <summary>
+/// PushButtonCurveTable Template Class
+/// </summary>
+/// <remarks>
+/// The lookup table of N periods of the CURVE (any class with a constexpr static period(i)),
+/// computed at compile time and kept in program memory on AVR
+/// PushButtonCurveTable&lt;PushButtonExponentialCurve&lt;300, 20, 10&gt;, 32&gt;::table
+/// </remarks>
+template < class CURVE, byte N, class = typename PushButtonCurveBuild<N>::type >
+struct PushButtonCurveTable;
+
+template < class CURVE, byte N, unsigned int... I >
+struct PushButtonCurveTable<CURVE, N, PushButtonCurveIndices<I...> >
+{
+	static_assert(N > 0, "the curve needs at least one period");
+	/// <summary> the number of periods in the table </summary>
+	static const byte length = N;
+	/// <summary> the periods in milliseconds </summary>
+	static const uint16_t table[N];
+};
+
+template < class CURVE, byte N, unsigned int... I >
+const uint16_t PushButtonCurveTable<CURVE, N, PushButtonCurveIndices<I...> >::table[N] YAPUSHBUTTON_PROGMEM = { CURVE::period(I)... };
+
+/// <summary>
+/// PushButtonCurveAutoRepeat Template Class
+/// </summary>
+/// <remarks>
+/// Implements a push button functionality with debouncing and autorepeat following an acceleration curve
+/// ACT determines active low = false (default)
+/// - push button that connects to GND when pressed
+/// or active high push button
+/// The curve is a table of repeat periods in milliseconds (uint16_t, in program memory on AVR - YAPUSHBUTTON_PROGMEM),
+/// the first one between the first and the second autorepeated keypress, then one entry further on each keypress,
+/// staying at the last one.
+/// Any shape can be given - exponential, S-shaped, stepped (repeating entries) ... handle() only
+/// moves the index on each keypress due (also the ones a late call skips or counts), the current period is kept in RAM, so it costs the same as PushButtonAutoRepeat
+/// The keypresses after the period got shorter than the first one are reported as BUTTON_EVENT_ACCELERATED_REPEAT
+/// </remarks>
+template < bool ACT = false, class HAL = YAPUSHBUTTON_DEFAULT_HAL, template < typename > class DEBOUNCER = PushButtonTimeWindow >
+class PushButtonCurveAutoRepeat : public PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>
+{
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::lastChangeTime;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::repeatDelay;
+	using PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::repeatPeriod;
+
+public:
+	/// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	typedef typename PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::time_type time_type;
+
+protected:
+	/// <summary> the periods of the curve in milliseconds </summary>
+	const uint16_t *curve;
+	/// <summary> the number of periods in the curve </summary>
+	byte curveLength;
+	/// <summary> the index of the current period </summary>
+	byte curveIndex;
+	/// <summary> the current period (HAL ticks) </summary>
+	time_type currentRepeatPeriod;
+
+	/// <summary> Reads a period from the curve (from program memory on AVR) </summary>
+	/// <param name="i"> The index of the period </param>
+	/// <returns> the period in milliseconds </returns>
+	uint16_t readCurve(byte i) const
+	{
+#if defined(__AVR__) && !defined(YAPUSHBUTTON_HOST)
+		return pgm_read_word(curve + i);
+#else
+		return curve[i];
+#endif
+	}
+
+	/// <summary> The schedule along the curve - one entry further after each keypress due (PushButtonRepeatSchedule::run()) </summary>
+	struct Steps
+	{
+		PushButtonCurveAutoRepeat *button;
+		/// <summary> true before the first autorepeated keypress - it ends the repeat delay, the curve starts after it </summary>
+		bool first;
+		time_type period() const
+		{
+			return button->currentRepeatPeriod;
+		}
+		byte kind() const
+		{
+			return button->currentRepeatPeriod < button->repeatPeriod ? BUTTON_EVENT_ACCELERATED_REPEAT : BUTTON_EVENT_REPEAT;
+		}
+		bool step()
+		{
+			if (first)
+			{
+				first = false;
+				return button->curveLength > 1;
+			}
+			if (button->curveIndex >= button->curveLength - 1) // stays at the last period
+				return false;
+			button->curveIndex++;
+			button->currentRepeatPeriod = HAL::toTicks(button->readCurve(button->curveIndex));
+			return true;
+		}
+	};
+
+	/// <summary> Goes back to the beginning of the curve </summary>
+	void restartCurve()
+	{
+		curveIndex = 0;
+		currentRepeatPeriod = repeatPeriod;
+	}
+
+public:
+	/// <summary> PushButtonCurveAutoRepeat constructor </summary>
+	/// <param name="pbPin"> The pin the button is connected to </param>
+	/// <param name="KeyPressCallBackFunction"> The function to be called on each keypress </param>
+	/// <param name="Curve"> The repeat periods in milliseconds (in program memory on AVR) </param>
+	/// <param name="CurveLength"> The number of periods in the curve (at least 1) </param>
+	/// <param name="RepeatDelay"> The delay in milliseconds before autorepeat begins </param>
+	/// <param name="DebounceDelay"> The delay in milliseconds for debouncing </param>
+	PushButtonCurveAutoRepeat(byte pbPin, void(*KeyPressCallBackFunction)(), const uint16_t *Curve, byte CurveLength,
+		unsigned long RepeatDelay = 500, unsigned long DebounceDelay = 50)
+		: PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>(pbPin, KeyPressCallBackFunction, RepeatDelay, 0, DebounceDelay)
+	{
+		setCurve(Curve, CurveLength);
+	}
+
+	/// <summary> Sets the acceleration curve </summary>
+	/// <param name="Curve"> The repeat periods in milliseconds (in program memory on AVR) </param>
+	/// <param name="CurveLength"> The number of periods in the curve (at least 1) </param>
+	/// <remark> the repeat period (getRepeatPeriod()) is the first period of the curve </remark>
+	void setCurve(const uint16_t *Curve, byte CurveLength)
+	{
+#ifndef NDEBUG
+		assert(Curve && CurveLength);
+#endif
+		curve = Curve;
+		curveLength = CurveLength;
+#ifndef NDEBUG
+		for (byte i = 0; i < CurveLength; i++)
+			assert(readCurve(i) <= this->maxDelay());
+#endif
+		repeatPeriod = HAL::toTicks(readCurve(0));
+		restartCurve();
+	}
+
+	/// <summary> The position on the curve </summary>
+	/// <returns> the index of the period the next keypress is waiting for </returns>
+	byte getCurveIndex() const
+	{
+		return curveIndex;
+	}
+
+	/// <summary> To be called repeatedly in a loop (services auto repeating calls) </summary>
+	/// <remark> after repeatDelay the keypresses follow the periods of the curve </remark>
+	void handle()
+	{
+		handle(HAL::now());
+	}
+
+	/// <summary> Services auto repeating calls at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(time_type now)
+	{
+		typename PushButtonAutoRepeat<ACT, HAL, DEBOUNCER>::Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Services auto repeating at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the ButtonEvent on each keypress instead of the callback </param>
+	template < class F >
+	void handle(time_type now, F &&f)
+	{
+		time_type bpDur = this->heldDown(now);
+		if (!this->getSinglePress() && bpDur)
+		{
+			f(this->nextEvent(BUTTON_EVENT_PRESS));
+			this->setSinglePress(true);
+			lastChangeTime = now;
+			restartCurve();
+		}
+		Steps steps = { this, this->repeatCount == 0 };
+		this->repeatOn(now, bpDur, repeatDelay, steps, f);
+		if (bpDur == 0)
+			this->setSinglePress(false);
+	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until debounce expires or the next autorepeat keypress (0 if due),
+	/// or maxTime() if only a press or release can produce the next event </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		return this->nextRepeatIn(now, currentRepeatPeriod);
+	}
+};
+
+#endif
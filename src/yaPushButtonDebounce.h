@@ -0,0 +1,159 @@
+// yaPushButtonDebounce.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// debounce policies sampling the button over the whole debounce period - a saturating integrator
+// and a shift register history, more robust against noise than the default time window
+// passed as DEBOUNCER template parameter to PushButton and the autorepeat classes
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONDEBOUNCE_h
+#define _YAPUSHBUTTONDEBOUNCE_h
+
+#include "yaPushButton.h"
+
+/// <summary>
+/// PushButtonSaturatingIntegrator Template Class
+/// </summary>
+/// <remarks>
+/// Debounce policy counting the samples - up for each sample in the new state, down for each in the old one,
+/// the state changes when the count saturates at MAX and the change is dropped when it falls back to 0,
+/// so isolated noisy samples only delay the decision instead of deciding it
+/// The button is sampled every debounceDelay/(MAX-1), a clean change is taken after about debounceDelay
+/// but not before MAX-1 ticks - the samples are at least 1 tick apart, a shorter debounceDelay
+/// (less than 7 ms for PushButtonIntegrator on a millisecond HAL) takes MAX-1 ticks
+/// T is the time type of the HAL, MAX between 2 and 255 (PushButtonIntegrator uses 8)
+/// </remarks>
+template < typename T, byte MAX >
+class PushButtonSaturatingIntegrator
+{
+	static_assert(MAX >= 2, "PushButtonSaturatingIntegrator needs MAX of at least 2");
+
+	/// <summary> the time of the last sample </summary>
+	T lastSample;
+	/// <summary> the samples in the new state minus those in the old one </summary>
+	byte count;
+	/// <summary> the state debounced </summary>
+	bool target;
+
+	/// <summary> The time between the samples (at least 1 tick) </summary>
+	static T period(T delay)
+	{
+		return delay >= MAX - 1 ? (T)(delay / (MAX - 1)) : (T)1;
+	}
+
+protected:
+	/// <summary> Starts debouncing a state change </summary>
+	/// <param name="now"> The time the state change has been spotted </param>
+	/// <param name="current"> The new state of the button </param>
+	void debounceStart(T now, bool current)
+	{
+		lastSample = now;
+		count = 1;
+		target = current;
+	}
+
+	/// <summary> Samples the button while debouncing </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="current"> The state of the button now </param>
+	/// <param name="since"> The time the state change has been spotted </param>
+	/// <param name="delay"> The debounce delay </param>
+	/// <returns> true when the count saturates or falls back to 0 (current is the debounced state) </returns>
+	bool debounceSettled(T now, bool current, T, T delay)
+	{
+		if ((T)(now - lastSample) < period(delay))
+			return false;
+		lastSample = now;
+		if (current == target)
+			return ++count >= MAX;
+		return --count == 0;
+	}
+
+	/// <summary> The time until the next sample </summary>
+	/// <returns> the time in HAL ticks (0 if due) </returns>
+	T debounceNextIn(T now, T, T delay) const
+	{
+		T elapsed = (T)(now - lastSample);
+		return elapsed >= period(delay) ? 0 : (T)(period(delay) - elapsed);
+	}
+};
+
+/// <summary>
+/// PushButtonShiftRegister Template Class
+/// </summary>
+/// <remarks>
+/// Debounce policy keeping the history of the samples in the bits of H (byte or uint16_t),
+/// bit set for a sample in the new state - the state changes when the history is all ones
+/// and the change is dropped when it is all zeros (the old state is stable again)
+/// Needs all the samples over the debounce period in agreement, so it rejects more noise
+/// than the integrator, but noise keeps postponing the decision - a spike on any sample restarts the wait,
+/// so with about one spike per debounce period or more a short press can end before the history is all ones
+/// and is missed (the benchmark noise set - a spike every 20 ms on average, 150 ms presses, 50 ms debounce -
+/// misses about one press in seven with 16 samples, none with the integrator)
+/// The button is sampled every debounceDelay/(bits-1), a clean change is taken after about debounceDelay
+/// but not before bits-1 ticks - the samples are at least 1 tick apart, a shorter debounceDelay
+/// (less than 7 or 15 ms on a millisecond HAL) takes bits-1 ticks
+/// T is the time type of the HAL (PushButtonShiftRegister8 and PushButtonShiftRegister16 for 8 and 16 samples)
+/// </remarks>
+template < typename T, typename H >
+class PushButtonShiftRegister
+{
+	/// <summary> the time of the last sample </summary>
+	T lastSample;
+	/// <summary> the samples, the latest in bit 0 </summary>
+	H history;
+	/// <summary> the state debounced </summary>
+	bool target;
+
+	/// <summary> The time between the samples (at least 1 tick) </summary>
+	static T period(T delay)
+	{
+		return delay >= sizeof(H) * 8 - 1 ? (T)(delay / (sizeof(H) * 8 - 1)) : (T)1;
+	}
+
+protected:
+	/// <summary> Starts debouncing a state change </summary>
+	/// <param name="now"> The time the state change has been spotted </param>
+	/// <param name="current"> The new state of the button </param>
+	void debounceStart(T now, bool current)
+	{
+		lastSample = now;
+		history = 1;
+		target = current;
+	}
+
+	/// <summary> Samples the button while debouncing </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="current"> The state of the button now </param>
+	/// <param name="since"> The time the state change has been spotted </param>
+	/// <param name="delay"> The debounce delay </param>
+	/// <returns> true when the history is all ones or all zeros (current is the debounced state) </returns>
+	bool debounceSettled(T now, bool current, T, T delay)
+	{
+		if ((T)(now - lastSample) < period(delay))
+			return false;
+		lastSample = now;
+		history = (H)((history << 1) | (current == target));
+		return history == (H)~(H)0 || history == 0;
+	}
+
+	/// <summary> The time until the next sample </summary>
+	/// <returns> the time in HAL ticks (0 if due) </returns>
+	T debounceNextIn(T now, T, T delay) const
+	{
+		T elapsed = (T)(now - lastSample);
+		return elapsed >= period(delay) ? 0 : (T)(period(delay) - elapsed);
+	}
+};
+
+/// <summary> Saturating integrator counting up to 8 samples </summary>
+template < typename T >
+using PushButtonIntegrator = PushButtonSaturatingIntegrator<T, 8>;
+
+/// <summary> Shift register history of 8 samples </summary>
+template < typename T >
+using PushButtonShiftRegister8 = PushButtonShiftRegister<T, byte>;
+
+/// <summary> Shift register history of 16 samples </summary>
+template < typename T >
+using PushButtonShiftRegister16 = PushButtonShiftRegister<T, uint16_t>;
+
+#endif
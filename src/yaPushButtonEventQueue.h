@@ -0,0 +1,253 @@
+// yaPushButtonEventQueue.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// fixed capacity queue of button events - the buttons are scanned and their events
+// queued, the application drains the queue whenever it gets to it, so no event is lost
+// or consumed by the wrong caller when scanning and event handling are not in step
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONEVENTQUEUE_h
+#define _YAPUSHBUTTONEVENTQUEUE_h
+
+#include "yaPushButton.h"
+#include "yaPushButtonRingBuffer.h"
+
+#if defined(__AVR__) && !defined(YAPUSHBUTTON_HOST)
+#include <avr/interrupt.h>
+#endif
+
+/// <summary> Keeps the interrupts off while in scope, restores them as they were </summary>
+/// <remarks> only on AVR, where a 16-bit counter written by an interrupt handler can be read half old half new -
+/// elsewhere the counters are read and written in one access </remarks>
+struct PushButtonInterruptLock
+{
+#if defined(__AVR__) && !defined(YAPUSHBUTTON_HOST)
+	uint8_t sreg;
+	PushButtonInterruptLock() : sreg(SREG)
+	{
+		cli();
+	}
+	~PushButtonInterruptLock()
+	{
+		SREG = sreg;
+	}
+#else
+	PushButtonInterruptLock()
+	{ }
+#endif
+};
+
+/// <summary> The types of the queued events </summary>
+/// <remarks> BUTTON_QUEUED_PRESSED and BUTTON_QUEUED_RELEASED have the values of BUTTON_PRESSED and BUTTON_RELEASED </remarks>
+enum ButtonQueuedEventType
+{
+	BUTTON_QUEUED_PRESSED = BUTTON_PRESSED,
+	BUTTON_QUEUED_RELEASED = BUTTON_RELEASED,
+	BUTTON_QUEUED_KEYPRESS, // first keypress of an autorepeat button
+	BUTTON_QUEUED_REPEAT, // autorepeated keypress
+	BUTTON_QUEUED_ACCELERATED_REPEAT // autorepeated keypress at faster speed
+};
+
+/// <summary> An event in the queue </summary>
+/// <remarks> T is the time type of the HAL </remarks>
+template < typename T >
+struct PushButtonQueuedEvent
+{
+	/// <summary> the id of the button (given by the producer) </summary>
+	byte id;
+	/// <summary> the type of the event (ButtonQueuedEventType) </summary>
+	byte type;
+	/// <summary> the time the event happened (HAL ticks) - the edge of a press or a release
+	/// (getStateChangedTime() of the button), the time an autorepeated keypress was reported </summary>
+	T time;
+	/// <summary> for how long the button has been held pressed - on release and autorepeated keypresses (HAL ticks) </summary>
+	T held;
+	/// <summary> the number of keypresses the event stands for - 1, more only for autorepeated keypresses 
+	/// of a button with BUTTON_CATCHUP_COUNT (ButtonEvent::count) </summary>
+	unsigned int count;
+};
+
+/// <summary>
+/// PushButtonEventQueue Template Class
+/// </summary>
+/// <remarks>
+/// Queues the events of up to IDS buttons (ids 0 .. IDS-1, at most 32), holding up to N-1 events
+/// (N a power of 2, at most 128) in a lock-free ring buffer - one producer and one consumer,
+/// so the buttons can also be serviced from a timer interrupt while the loop drains the queue
+/// poll() services a plain button with stateChanged() and queues presses and releases,
+/// handle() services an autorepeat button with handle(now, f) and queues its keypresses and releases,
+/// the keypresses coalesced by BUTTON_CATCHUP_COUNT are queued as one event with their number in count
+/// If the queue is full the new events are dropped and counted (dropped()) - dropped() and resetDropped()
+/// keep the interrupts off while they access the counter (on AVR), so the producer can be an interrupt handler
+/// </remarks>
+template < byte N = 16, byte IDS = 8, class HAL = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonEventQueue
+{
+	static_assert(IDS >= 1 && IDS <= 32, "PushButtonEventQueue supports up to 32 button ids");
+
+public:
+	/// <summary> the type of the timestamps (HAL ticks) </summary>
+	typedef typename HAL::time_type time_type;
+	/// <summary> the type of the queued events </summary>
+	typedef PushButtonQueuedEvent<time_type> Event;
+
+protected:
+	/// <summary> the events </summary>
+	PushButtonRingBuffer<Event, N> events;
+	/// <summary> the time (of the edge) each of the buttons has been pressed </summary>
+	time_type pressTime[IDS];
+	/// <summary> bit set for the buttons that are (debounced) pressed </summary>
+	uint32_t downMask;
+	/// <summary> the number of events dropped because the queue was full (written by the producer, reset by the consumer) </summary>
+	volatile unsigned int droppedCount;
+
+	/// <summary> Queues an event </summary>
+	void push(byte id, byte type, time_type now, time_type held, unsigned int count = 1)
+	{
+		Event e;
+		e.id = id;
+		e.type = type;
+		e.time = now;
+		e.held = held;
+		e.count = count;
+		if (!events.push(e))
+			droppedCount++;
+	}
+
+	/// <summary> Tracks the press / release of a button and queues the release </summary>
+	/// <param name="now"> The time of the edge of the press or the release </param>
+	void track(byte id, bool down, time_type now)
+	{
+#ifndef NDEBUG
+		assert(id < IDS);
+#endif
+		uint32_t bit = (uint32_t)1 << id;
+		if (down == !!(downMask & bit))
+			return;
+		if (down)
+		{
+			downMask |= bit;
+			pressTime[id] = now;
+		}
+		else
+		{
+			downMask &= ~bit;
+			push(id, BUTTON_QUEUED_RELEASED, now, (time_type)(now - pressTime[id]));
+		}
+	}
+
+	/// <summary> Functor queueing the keypresses reported by handle(now, f) of an autorepeat button </summary>
+	/// <remarks> the first keypress at the time of the edge of the press, the autorepeated ones when reported </remarks>
+	template < class B >
+	struct Producer
+	{
+		PushButtonEventQueue *queue;
+		const B *button;
+		byte id;
+		time_type now;
+		void operator()(ButtonEvent e) const
+		{
+			if (e.kind == BUTTON_EVENT_PRESS)
+			{
+				queue->track(id, true, button->getStateChangedTime());
+				queue->push(id, BUTTON_QUEUED_KEYPRESS, queue->pressTime[id], 0);
+			}
+			else
+				queue->push(id, BUTTON_QUEUED_KEYPRESS + e.kind, now, (time_type)(now - queue->pressTime[id]), e.count);
+		}
+	};
+
+public:
+	/// <summary> PushButtonEventQueue constructor </summary>
+	PushButtonEventQueue() : downMask(0), droppedCount(0)
+	{ }
+
+	/// <summary> Services a button with stateChanged() and queues its presses and releases </summary>
+	/// <param name="id"> The id of the button (0 .. IDS-1) </param>
+	/// <param name="button"> The button </param>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE (the event is queued as well) </returns>
+	template < class B >
+	byte poll(byte id, B &button, time_type now)
+	{
+		byte r = button.stateChanged(now);
+		if (r == BUTTON_PRESSED)
+		{
+			track(id, true, button.getStateChangedTime());
+			push(id, BUTTON_QUEUED_PRESSED, pressTime[id], 0);
+		}
+		else if (r == BUTTON_RELEASED)
+			track(id, false, button.getStateChangedTime());
+		return r;
+	}
+
+	/// <summary> Services an autorepeat button with handle() and queues its keypresses and the release </summary>
+	/// <param name="id"> The id of the button (0 .. IDS-1) </param>
+	/// <param name="button"> The button </param>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <remark> the keypresses are queued instead of calling the registered callback </remark>
+	template < class B >
+	void handle(byte id, B &button, time_type now)
+	{
+		Producer<B> p = { this, &button, id, now };
+		button.handle(now, p);
+		if (!button.isDown())
+			track(id, false, button.getStateChangedTime());
+	}
+
+	/// <summary> Takes the oldest event from the queue </summary>
+	/// <param name="e"> Receives the event </param>
+	/// <returns> false if the queue is empty </returns>
+	bool pop(Event &e)
+	{
+		return events.pop(e);
+	}
+
+	/// <summary> Takes up to max events from the queue at once </summary>
+	/// <param name="buffer"> Receives the events, oldest first </param>
+	/// <param name="max"> The size of the buffer </param>
+	/// <returns> the number of events taken </returns>
+	byte drain(Event *buffer, byte max)
+	{
+		byte n = 0;
+		while (n < max && events.pop(buffer[n]))
+			n++;
+		return n;
+	}
+
+	/// <summary> Removes all the events from the queue </summary>
+	void clear()
+	{
+		events.clear();
+	}
+
+	/// <summary> Is the queue empty </summary>
+	/// <returns> true if there are no events waiting </returns>
+	bool empty() const
+	{
+		return events.empty();
+	}
+
+	/// <summary> The number of events in the queue </summary>
+	/// <returns> the number of events waiting to be taken </returns>
+	byte count() const
+	{
+		return events.count();
+	}
+
+	/// <summary> The number of events dropped because the queue was full </summary>
+	/// <returns> the number of dropped events since the last reset </returns>
+	unsigned int dropped() const
+	{
+		PushButtonInterruptLock lock;
+		return droppedCount;
+	}
+
+	/// <summary> Resets the counter of dropped events </summary>
+	void resetDropped()
+	{
+		PushButtonInterruptLock lock;
+		droppedCount = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,360 @@
+// yaPushButtonGestures.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// gesture recognition on top of the debounced button - click, double click, N taps,
+// long press and chords of several buttons pressed together
+// a small transition table drives a fixed size state machine per button
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONGESTURES_h
+#define _YAPUSHBUTTONGESTURES_h
+
+#include "yaPushButton.h"
+
+/// <summary> The gestures reported by PushButtonGestures::update() </summary>
+enum ButtonGesture { GESTURE_NONE, GESTURE_CLICK, GESTURE_DOUBLE_CLICK, GESTURE_MULTI_TAP, GESTURE_LONG_PRESS };
+
+/// <summary>
+/// PushButtonGestures Template Class
+/// </summary>
+/// <remarks>
+/// Recognizes gestures from the debounced presses and releases of a push button
+/// ACT determines active low = false (default)
+/// - push button that connects to GND when pressed
+/// or active high push button
+/// A tap is a press released before longPressDelay, taps following each other with less than
+/// tapGap between a release and the next press are counted together and reported when no
+/// other tap follows (or at once when maxTaps is reached) as GESTURE_CLICK (1 tap),
+/// GESTURE_DOUBLE_CLICK (2 taps) or GESTURE_MULTI_TAP (more, taps() tells how many).
+/// A press held for longer than longPressDelay is reported as GESTURE_LONG_PRESS while still held
+/// (the taps before it are dropped). The state per button is a timestamp and 3 bytes.
+/// </remarks>
+template < bool ACT = false, class HAL = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonGestures : public PushButton<ACT, HAL>
+{
+	using PushButton<ACT, HAL>::previousButtonState;
+	using PushButton<ACT, HAL>::stateChangedTimeStamp;
+	using PushButton<ACT, HAL>::debounceWaiting;
+
+public:
+	/// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	typedef typename PushButton<ACT, HAL>::time_type time_type;
+
+protected:
+	/// <summary> the states of the recognizer </summary>
+	enum { STATE_IDLE, STATE_DOWN, STATE_UP, STATE_HOLD };
+	/// <summary> the inputs of the recognizer (debounced press, release, timeout of the current state) </summary>
+	enum { INPUT_PRESS, INPUT_RELEASE, INPUT_TIMEOUT };
+	/// <summary> the actions taken on a transition </summary>
+	enum { ACTION_NONE, ACTION_TAP, ACTION_RELEASE, ACTION_EMIT_TAPS, ACTION_EMIT_LONG };
+
+	/// <summary> The transition table - the next state (high nibble) and the action (low nibble) </summary>
+	/// <param name="state"> The current state </param>
+	/// <param name="input"> The input </param>
+	static byte transition(byte state, byte input)
+	{
+		static const byte table[4][3] =
+		{
+			//              INPUT_PRESS                      INPUT_RELEASE                     INPUT_TIMEOUT
+			/* IDLE */ { (STATE_DOWN << 4) | ACTION_TAP, (STATE_IDLE << 4) | ACTION_NONE,    (STATE_IDLE << 4) | ACTION_NONE },
+			/* DOWN */ { (STATE_DOWN << 4) | ACTION_NONE, (STATE_UP << 4) | ACTION_RELEASE,  (STATE_HOLD << 4) | ACTION_EMIT_LONG },
+			/* UP   */ { (STATE_DOWN << 4) | ACTION_TAP, (STATE_UP << 4) | ACTION_NONE,      (STATE_IDLE << 4) | ACTION_EMIT_TAPS },
+			/* HOLD */ { (STATE_HOLD << 4) | ACTION_NONE, (STATE_IDLE << 4) | ACTION_NONE,   (STATE_HOLD << 4) | ACTION_NONE }
+		};
+		return table[state][input];
+	}
+
+// configuration
+	/// <summary> the time the button has to be held for a long press </summary>
+	time_type longPressDelay;
+	/// <summary> the longest time between a release and the next press counted as the same gesture </summary>
+	time_type tapGap;
+	/// <summary> the number of taps reported at once without waiting for tapGap </summary>
+	byte maxTaps;
+
+// operation
+	/// <summary> the time the edge of the last press or release was seen </summary>
+	time_type gestureTimeStamp;
+	/// <summary> the state of the recognizer </summary>
+	byte state;
+	/// <summary> the number of taps counted in the current gesture </summary>
+	byte tapCount;
+	/// <summary> the number of taps of the last reported tap gesture </summary>
+	byte lastTaps;
+
+	/// <summary> Has the current state timed out </summary>
+	bool timedOut(time_type now) const
+	{
+		time_type elapsed = (time_type)(now - gestureTimeStamp);
+		if (state == STATE_DOWN)
+			return elapsed > longPressDelay;
+		if (state == STATE_UP)
+			return elapsed > tapGap;
+		return false;
+	}
+
+	/// <summary> Reports the counted taps and starts over </summary>
+	byte emitTaps()
+	{
+		lastTaps = tapCount;
+		tapCount = 0;
+		state = STATE_IDLE;
+		return lastTaps == 1 ? GESTURE_CLICK : lastTaps == 2 ? GESTURE_DOUBLE_CLICK : GESTURE_MULTI_TAP;
+	}
+
+	/// <summary> Takes the recognizer through the transition for the input </summary>
+	/// <param name="input"> INPUT_PRESS, INPUT_RELEASE or INPUT_TIMEOUT </param>
+	/// <param name="now"> The time of the input </param>
+	/// <returns> the gesture completed by the transition, GESTURE_NONE if none </returns>
+	byte apply(byte input, time_type now)
+	{
+		byte t = transition(state, input);
+		state = t >> 4;
+		switch (t & 0x0F)
+		{
+		case ACTION_TAP:
+			tapCount++;
+			gestureTimeStamp = now;
+			break;
+		case ACTION_RELEASE:
+			gestureTimeStamp = now;
+			if (tapCount >= maxTaps) // no need to wait for more
+				return emitTaps();
+			break;
+		case ACTION_EMIT_TAPS:
+			return emitTaps();
+		case ACTION_EMIT_LONG:
+			tapCount = 0;
+			return GESTURE_LONG_PRESS;
+		}
+		return GESTURE_NONE;
+	}
+
+public:
+	/// <summary> PushButtonGestures constructor </summary>
+	/// <param name="pbPin"> The pin the button is connected to </param>
+	/// <param name="LongPressDelay"> The time in milliseconds the button has to be held for a long press </param>
+	/// <param name="TapGap"> The longest time in milliseconds between a release and the next press of a multi tap </param>
+	/// <param name="MaxTaps"> The number of taps reported at once, without waiting for the next one </param>
+	/// <param name="DebounceDelay"> The delay in milliseconds for debouncing </param>
+	PushButtonGestures(byte pbPin, unsigned long LongPressDelay = 800, unsigned long TapGap = 250,
+		byte MaxTaps = 255, unsigned long DebounceDelay = 50) :
+		PushButton<ACT, HAL>(pbPin, DebounceDelay), longPressDelay(PushButton<ACT, HAL>::delayTicks(LongPressDelay)),
+		tapGap(PushButton<ACT, HAL>::delayTicks(TapGap)), maxTaps(MaxTaps), gestureTimeStamp(0), state(STATE_IDLE), tapCount(0), lastTaps(0)
+	{ }
+
+	/// <summary> initializes the PushButtonGestures object </summary>
+	void init()
+	{
+		PushButton<ACT, HAL>::init();
+		state = STATE_IDLE;
+		tapCount = lastTaps = 0;
+	}
+
+	/// <summary> Sets the time the button has to be held for a long press </summary>
+	/// <param name="LongPressDelay"> The time in milliseconds </param>
+	void setLongPressDelay(unsigned long LongPressDelay)
+	{
+		longPressDelay = this->delayTicks(LongPressDelay);
+	}
+
+	/// <summary> Gets the time the button has to be held for a long press </summary>
+	/// <returns> The time in milliseconds </returns>
+	unsigned long getLongPressDelay() const
+	{
+		return HAL::toMillis(longPressDelay);
+	}
+
+	/// <summary> Sets the longest time between a release and the next press of a multi tap </summary>
+	/// <param name="TapGap"> The time in milliseconds </param>
+	void setTapGap(unsigned long TapGap)
+	{
+		tapGap = this->delayTicks(TapGap);
+	}
+
+	/// <summary> Gets the longest time between a release and the next press of a multi tap </summary>
+	/// <returns> The time in milliseconds </returns>
+	unsigned long getTapGap() const
+	{
+		return HAL::toMillis(tapGap);
+	}
+
+	/// <summary> Sets the number of taps reported at once without waiting for the next one </summary>
+	/// <param name="MaxTaps"> The number of taps (1 - report single clicks at once, no double clicks) </param>
+	void setMaxTaps(byte MaxTaps)
+	{
+		maxTaps = MaxTaps;
+	}
+
+	/// <summary> The number of taps of the last reported tap gesture </summary>
+	/// <returns> the number of taps (1 for GESTURE_CLICK, 2 for GESTURE_DOUBLE_CLICK ...) </returns>
+	byte taps() const
+	{
+		return lastTaps;
+	}
+
+	/// <summary> Drops the gesture in progress - nothing is reported until the button is released </summary>
+	/// <remark> for example when the button has been used as a part of a chord </remark>
+	void cancel()
+	{
+		tapCount = 0;
+		state = previousButtonState ? STATE_HOLD : STATE_IDLE;
+	}
+
+	/// <summary> Recognizes the gestures </summary>
+	/// <returns> GESTURE_NONE, GESTURE_CLICK, GESTURE_DOUBLE_CLICK, GESTURE_MULTI_TAP or GESTURE_LONG_PRESS </returns>
+	/// <remark> To be called repeatedly in a loop (instead of stateChanged()) </remark>
+	byte update()
+	{
+		return update(HAL::now());
+	}
+
+	/// <summary> Recognizes the gestures at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> GESTURE_NONE, GESTURE_CLICK, GESTURE_DOUBLE_CLICK, GESTURE_MULTI_TAP or GESTURE_LONG_PRESS </returns>
+	byte update(time_type now)
+	{
+		byte change = this->stateChanged(now);
+		// a press or release counts at the time its edge was seen - the timeout of the current state is taken
+		// only if it had passed by then, so a loop stalled while the edge was debounced does not split the gesture
+		// (while an edge is debounced the timeout waits for it, a glitch lets it go on the next call)
+		time_type at = (change == BUTTON_NOCHANGE && !debounceWaiting) ? now : stateChangedTimeStamp;
+		byte gesture = GESTURE_NONE;
+		if (timedOut(at))
+			gesture = apply(INPUT_TIMEOUT, at);
+		if (change == BUTTON_PRESSED || change == BUTTON_RELEASED)
+		{
+			byte g = apply(change == BUTTON_PRESSED ? INPUT_PRESS : INPUT_RELEASE, at);
+			if (g != GESTURE_NONE)
+				gesture = g;
+		}
+		return gesture;
+	}
+
+	/// <summary> Is the recognizer idle - released, not debouncing and no gesture in progress </summary>
+	/// <returns> true if only pressing the button can produce the next gesture </returns>
+	bool isIdle() const
+	{
+		return state == STATE_IDLE && PushButton<ACT, HAL>::isIdle();
+	}
+
+	/// <summary> The time until the next gesture the button can report unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks (0 if due), or maxTime() if only a press or release can produce the next event </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		time_type next = PushButton<ACT, HAL>::nextEventIn(now);
+		time_type t = next;
+		if (state == STATE_DOWN)
+			t = this->untilElapsed(now, gestureTimeStamp, longPressDelay);
+		else if (state == STATE_UP)
+			t = this->untilElapsed(now, gestureTimeStamp, tapGap);
+		return t < next ? t : next;
+	}
+};
+
+/// <summary>
+/// PushButtonChords Template Class
+/// </summary>
+/// <remarks>
+/// Detects chords - combinations of buttons pressed together
+/// T is the type of the bitmask of the buttons (byte, uint16_t or uint32_t), N the number of chords
+/// The chords are registered as bitmasks, update() is given the bitmask of the (debounced) pressed
+/// buttons and reports a chord once when exactly its buttons are down and all of them have been
+/// pressed within the chord window from the first one. A new chord can be reported only
+/// after all the buttons have been released.
+/// </remarks>
+template < byte N = 4, typename T = byte, class HAL = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonChords
+{
+public:
+	/// <summary> the type of the timestamps (HAL ticks) </summary>
+	typedef typename HAL::time_type time_type;
+
+protected:
+	/// <summary> the registered chords </summary>
+	T chords[N];
+	/// <summary> the number of registered chords </summary>
+	byte count;
+	/// <summary> the longest time between the first and the last press of a chord </summary>
+	time_type window;
+	/// <summary> the time the first button of the current combination has been pressed </summary>
+	time_type firstPressTime;
+	/// <summary> the buttons pressed on the previous update </summary>
+	T previous;
+	/// <summary> true while a chord can still be reported for the current combination </summary>
+	bool armed;
+
+public:
+	/// <summary> PushButtonChords constructor </summary>
+	/// <param name="Window"> The longest time in milliseconds between the first and the last press of a chord </param>
+	PushButtonChords(unsigned long Window = 200) : count(0), window(PushButton<false, HAL>::delayTicks(Window)), previous(0), armed(false)
+	{ }
+
+	/// <summary> Registers a chord </summary>
+	/// <param name="mask"> The buttons of the chord (at least 2 bits set) </param>
+	/// <returns> the number of the chord (1 .. N) reported by update(), 0 if there is no room for more </returns>
+	byte add(T mask)
+	{
+#ifndef NDEBUG
+		assert(mask & (T)(mask - 1)); // at least 2 buttons
+#endif
+		if (count >= N)
+			return 0;
+		chords[count++] = mask;
+		return count;
+	}
+
+	/// <summary> Sets the longest time between the first and the last press of a chord </summary>
+	/// <param name="Window"> The time in milliseconds </param>
+	void setWindow(unsigned long Window)
+	{
+		window = PushButton<false, HAL>::delayTicks(Window);
+	}
+
+	/// <summary> Gets the longest time between the first and the last press of a chord </summary>
+	/// <returns> The time in milliseconds </returns>
+	unsigned long getWindow() const
+	{
+		return HAL::toMillis(window);
+	}
+
+	/// <summary> Detects the chords </summary>
+	/// <param name="pressed"> The bitmask of the buttons (debounced) pressed now </param>
+	/// <returns> the number of the chord (1 .. N) just completed, 0 if none </returns>
+	byte update(T pressed)
+	{
+		return update(pressed, HAL::now());
+	}
+
+	/// <summary> Detects the chords at the given time </summary>
+	/// <param name="pressed"> The bitmask of the buttons (debounced) pressed now </param>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the number of the chord (1 .. N) just completed, 0 if none </returns>
+	byte update(T pressed, time_type now)
+	{
+		if (pressed == previous)
+			return 0;
+		if (!previous) // the first button of a new combination
+		{
+			firstPressTime = now;
+			armed = true;
+		}
+		previous = pressed;
+		if (!armed)
+			return 0;
+		if ((time_type)(now - firstPressTime) > window) // too late for a chord
+		{
+			armed = false;
+			return 0;
+		}
+		for (byte i = 0; i < count; i++)
+			if (pressed == chords[i])
+			{
+				armed = false;
+				return i + 1;
+			}
+		return 0;
+	}
+};
+
+#endif
@@ -0,0 +1,271 @@
+// yaPushButtonGroup.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// services a group of buttons of different classes in one call with a single time sample
+// the button types are kept in a compile-time list, so there are no virtual calls,
+// and idle buttons are skipped with a single pin read
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONGROUP_h
+#define _YAPUSHBUTTONGROUP_h
+
+#include "yaPushButton.h"
+
+/// <summary> Selects the smallest unsigned type with at least N bits (up to 32) </summary>
+template < byte N >
+struct ButtonGroupMask
+{
+	typedef uint32_t type;
+};
+template < >
+struct ButtonGroupMask<8>
+{
+	typedef byte type;
+};
+template < >
+struct ButtonGroupMask<16>
+{
+	typedef uint16_t type;
+};
+
+/// <summary> Picks the way each kind of button is serviced (resolved at compile time) </summary>
+struct ButtonGroupDispatch
+{
+	/// <summary> Buttons with handle() (autorepeat) - the callbacks report the events </summary>
+	template < class B, class T >
+	static auto service(B &b, T now, int) -> decltype(b.handle(now), byte())
+	{
+		b.handle(now);
+		return BUTTON_NOCHANGE;
+	}
+	/// <summary> Plain buttons - the state change is returned </summary>
+	template < class B, class T >
+	static byte service(B &b, T now, long)
+	{
+		return b.stateChanged(now);
+	}
+
+	/// <summary> Interrupt driven buttons - idle until an edge is captured </summary>
+	template < class B >
+	static auto quiet(B &b, int) -> decltype(b.captureEdge(), bool())
+	{
+		return b.isIdle();
+	}
+	/// <summary> Polled buttons - idle until the pin reads pressed </summary>
+	template < class B >
+	static bool quiet(B &b, long)
+	{
+		return !b.isPressed();
+	}
+};
+
+/// <summary> A node of the compile-time list of the buttons (I is the index of the button) </summary>
+template < byte I, class... B >
+class ButtonGroupNode;
+
+/// <summary> The end of the list </summary>
+template < byte I >
+class ButtonGroupNode<I>
+{
+public:
+	ButtonGroupNode()
+	{ }
+
+	template < class T, class M >
+	void update(T, M &, M &, M &)
+	{ }
+
+	template < class T, class M >
+	T nextEventIn(T, T next, M) const
+	{
+		return next;
+	}
+
+	template < class M >
+	M init()
+	{
+		return 0;
+	}
+};
+
+/// <summary> Holds the button I of the group and the rest of the list </summary>
+template < byte I, class B, class... R >
+class ButtonGroupNode<I, B, R...>
+{
+	B &button;
+	ButtonGroupNode<I + 1, R...> rest;
+
+public:
+	ButtonGroupNode(B &b, R &... r) : button(b), rest(r...)
+	{ }
+
+	/// <summary> Initializes the buttons, returns the initially active ones </summary>
+	template < class M >
+	M init()
+	{
+		button.init();
+		M active = rest.template init<M>();
+		if (!button.isIdle())
+			active |= (M)1 << I;
+		return active;
+	}
+
+	/// <summary> Services the active buttons and those leaving idle state </summary>
+	template < class T, class M >
+	void update(T now, M &active, M &pressed, M &released)
+	{
+		const M bit = (M)1 << I;
+		if ((active & bit) || !ButtonGroupDispatch::quiet(button, 0))
+		{
+			byte r = ButtonGroupDispatch::service(button, now, 0);
+			if (r == BUTTON_PRESSED)
+				pressed |= bit;
+			else if (r == BUTTON_RELEASED)
+				released |= bit;
+			if (button.isIdle())
+				active &= (M)~bit;
+			else
+				active |= bit;
+		}
+		rest.update(now, active, pressed, released);
+	}
+
+	/// <summary> The earliest deadline of the active buttons </summary>
+	template < class T, class M >
+	T nextEventIn(T now, T next, M active) const
+	{
+		if (active & ((M)1 << I))
+		{
+			T t = button.nextEventIn(now);
+			if (t < next)
+				next = t;
+		}
+		return rest.nextEventIn(now, next, active);
+	}
+};
+
+/// <summary>
+/// ButtonGroup Template Class
+/// </summary>
+/// <remarks>
+/// Services a group of up to 32 buttons of any of the button classes in one update() call
+/// B... are the types of the buttons - they all have to use the same HAL
+/// Buttons with handle() (autorepeat classes) are handled, the others polled with stateChanged()
+/// and their state changes collected in the pressed() / released() bitmasks (bit i for button i)
+/// A button is active while it is pressed or being debounced; idle buttons cost only one pin read
+/// (PushButtonInterrupt buttons not even that) until they are pressed, so a scan of many buttons
+/// costs little more than a scan of one while nothing is pressed
+/// The group holds references to the buttons - they have to outlive it
+/// </remarks>
+template < class... B >
+class ButtonGroup
+{
+	static_assert(sizeof...(B) >= 1 && sizeof...(B) <= 32, "ButtonGroup holds between 1 and 32 buttons");
+
+public:
+	/// <summary> the type of the bitmasks (byte, uint16_t or uint32_t - one bit per button) </summary>
+	typedef typename ButtonGroupMask<(sizeof...(B) <= 8 ? 8 : sizeof...(B) <= 16 ? 16 : 32)>::type mask_type;
+
+protected:
+	/// <summary> the buttons </summary>
+	ButtonGroupNode<0, B...> buttons;
+	/// <summary> the buttons that are not idle </summary>
+	mask_type active;
+	/// <summary> the buttons pressed on the last update </summary>
+	mask_type pressedMask;
+	/// <summary> the buttons released on the last update </summary>
+	mask_type releasedMask;
+
+	/// <summary> The first of the types (gives the HAL and the time type of the group) </summary>
+	template < class F, class... R >
+	struct First
+	{
+		typedef F type;
+	};
+
+public:
+	/// <summary> the hardware access policy of the buttons </summary>
+	typedef typename First<B...>::type::hal_type hal_type;
+	/// <summary> the type of the timestamps (HAL ticks) </summary>
+	typedef typename hal_type::time_type time_type;
+
+	/// <summary> ButtonGroup constructor </summary>
+	/// <param name="b"> The buttons (in the order of the template parameters) </param>
+	ButtonGroup(B &... b) : buttons(b...), active(0), pressedMask(0), releasedMask(0)
+	{ }
+
+	/// <summary> Initializes all the buttons in the group </summary>
+	void init()
+	{
+		active = buttons.template init<mask_type>();
+		pressedMask = releasedMask = 0;
+	}
+
+	/// <summary> The number of buttons in the group </summary>
+	static byte size()
+	{
+		return sizeof...(B);
+	}
+
+	/// <summary> Services all the buttons </summary>
+	/// <returns> bitmask of the polled buttons whose state has changed </returns>
+	/// <remark> To be called repeatedly in a loop </remark>
+	mask_type update()
+	{
+		return update(hal_type::now());
+	}
+
+	/// <summary> Services all the buttons at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> bitmask of the polled buttons whose state has changed </returns>
+	mask_type update(time_type now)
+	{
+		pressedMask = releasedMask = 0;
+		buttons.update(now, active, pressedMask, releasedMask);
+		return pressedMask | releasedMask;
+	}
+
+	/// <summary> The polled buttons that have been pressed on the last update </summary>
+	/// <returns> bitmask with bit set for each button that has just been pressed </returns>
+	mask_type pressed() const
+	{
+		return pressedMask;
+	}
+
+	/// <summary> The polled buttons that have been released on the last update </summary>
+	/// <returns> bitmask with bit set for each button that has just been released </returns>
+	mask_type released() const
+	{
+		return releasedMask;
+	}
+
+	/// <summary> State change of a single polled button on the last update </summary>
+	/// <param name="i"> The index of the button in the group </param>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	byte stateChanged(byte i) const
+	{
+		if ((pressedMask >> i) & 1)
+			return BUTTON_PRESSED;
+		if ((releasedMask >> i) & 1)
+			return BUTTON_RELEASED;
+		return BUTTON_NOCHANGE;
+	}
+
+	/// <summary> The buttons that are not idle (pressed or being debounced) </summary>
+	/// <returns> bitmask with bit set for each active button, 0 if all are idle </returns>
+	mask_type activity() const
+	{
+		return active;
+	}
+
+	/// <summary> The time until the earliest event of the buttons in the group </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks (0 if due), or the maximum value of time_type if
+	/// only pressing a button can produce the next event </returns>
+	/// <remark> the group can be registered to PushButtonSleepManager as a single button </remark>
+	time_type nextEventIn(time_type now) const
+	{
+		return buttons.nextEventIn(now, (time_type)~(time_type)0, active);
+	}
+};
+
+#endif
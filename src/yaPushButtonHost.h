@@ -0,0 +1,231 @@
+// yaPushButtonHost.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// host (PC) implementation of the hardware access policy with simulated time and pins
+// allows the button classes to be compiled, tested and profiled off-target
+// include this header instead of yaPushButton.h (it has to be included before it)
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONHOST_h
+#define _YAPUSHBUTTONHOST_h
+
+#ifdef _YAPUSHBUTTON_h
+#error "yaPushButtonHost.h has to be included before yaPushButton.h"
+#endif
+
+#define YAPUSHBUTTON_HOST
+#define YAPUSHBUTTON_DEFAULT_HAL PushButtonHostHAL
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef ARDUINO
+typedef uint8_t byte;
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#endif
+
+#ifndef YAPUSHBUTTON_HOST_PINS
+#define YAPUSHBUTTON_HOST_PINS 64
+#endif
+
+/// <summary> A level change of a simulated pin </summary>
+struct PushButtonHostEdge
+{
+	/// <summary> the (simulated) time in milliseconds the pin changes its level </summary>
+	unsigned long time;
+	/// <summary> the level of the pin from this time on (HIGH or LOW) </summary>
+	byte level;
+};
+
+/// <summary>
+/// PushButtonHostHAL Class
+/// </summary>
+/// <remarks>
+/// Hardware access policy for building the button classes on a host
+/// Time comes from a virtual clock that only moves when told to (setTime / advance)
+/// Pins are either set directly (setPin) or follow a recorded waveform - a list of edges
+/// sorted by time (setWaveform), which is evaluated against the virtual clock on each read
+/// Pins configured as INPUT_PULLUP idle HIGH, INPUT idle LOW
+/// The virtual clock is expected to only move forward (use rewind() to replay a waveform)
+/// </remarks>
+class PushButtonHostHAL
+{
+public:
+	/// <summary> the type of the timestamps (ticks are milliseconds here) </summary>
+	typedef unsigned long time_type;
+
+	/// <summary> The current time of the virtual clock </summary>
+	/// <returns> the time in milliseconds </returns>
+	static time_type now()
+	{
+		return clock();
+	}
+
+	/// <summary> Converts milliseconds to ticks </summary>
+	static constexpr time_type toTicks(unsigned long ms)
+	{
+		return ms;
+	}
+
+	/// <summary> Converts ticks to milliseconds </summary>
+	static constexpr unsigned long toMillis(time_type ticks)
+	{
+		return ticks;
+	}
+
+	/// <summary> Reads the simulated pin </summary>
+	/// <param name="pin"> The pin to be read </param>
+	/// <returns> HIGH or LOW </returns>
+	static int readPin(byte pin)
+	{
+		PinState &p = pinState(pin);
+		while (p.position < p.count && (long)(clock() - p.waveform[p.position].time) >= 0) // edges already passed
+			p.level = p.waveform[p.position++].level;
+		return p.level;
+	}
+
+	/// <summary> Configures the simulated pin </summary>
+	/// <param name="pin"> The pin to be configured </param>
+	/// <param name="mode"> INPUT or INPUT_PULLUP </param>
+	/// <remarks> sets the idle level of the pin unless a waveform is attached to it </remarks>
+	static void setupPin(byte pin, byte mode)
+	{
+		PinState &p = pinState(pin);
+		p.idleLevel = (mode == INPUT_PULLUP) ? HIGH : LOW;
+		if (!p.count)
+			p.level = p.idleLevel;
+	}
+
+	/// <summary> Reads the simulated analog input </summary>
+	/// <param name="pin"> The analog input to be read </param>
+	/// <returns> the value set by setAnalog() </returns>
+	static int readAnalog(byte pin)
+	{
+		return pinState(pin).analog;
+	}
+
+	/// <summary> Drives the simulated pin (detaches the waveform if any) </summary>
+	/// <param name="pin"> The pin </param>
+	/// <param name="level"> HIGH or LOW </param>
+	static void writePin(byte pin, byte level)
+	{
+		setPin(pin, level);
+	}
+
+	/// <summary> Waits for the given number of microseconds - the virtual clock counts milliseconds, so does nothing </summary>
+	static void delayMicros(unsigned int)
+	{ }
+
+	/// <summary> Idles until the next interrupt - here moves the virtual clock forward by 1 ms </summary>
+	static void idle()
+	{
+		clock()++;
+	}
+
+	/// <summary> Sets the virtual clock </summary>
+	/// <param name="t"> The time in milliseconds </param>
+	static void setTime(unsigned long t)
+	{
+		clock() = t;
+	}
+
+	/// <summary> Moves the virtual clock forward </summary>
+	/// <param name="dt"> The time in milliseconds to advance the clock by </param>
+	static void advance(unsigned long dt)
+	{
+		clock() += dt;
+	}
+
+	/// <summary> Sets the level of the simulated pin (detaches the waveform if any) </summary>
+	/// <param name="pin"> The pin </param>
+	/// <param name="level"> HIGH or LOW </param>
+	static void setPin(byte pin, byte level)
+	{
+		PinState &p = pinState(pin);
+		p.waveform = NULL;
+		p.count = p.position = 0;
+		p.level = level;
+	}
+
+	/// <summary> Sets the value of the simulated analog input </summary>
+	/// <param name="pin"> The analog input </param>
+	/// <param name="value"> The ADC reading </param>
+	static void setAnalog(byte pin, int value)
+	{
+		pinState(pin).analog = value;
+	}
+
+	/// <summary> Attaches a recorded waveform to the simulated pin </summary>
+	/// <param name="pin"> The pin </param>
+	/// <param name="edges"> The level changes sorted by time (not copied - has to outlive its use) </param>
+	/// <param name="count"> The number of edges </param>
+	/// <remarks> before the first edge the pin is at its idle level </remarks>
+	static void setWaveform(byte pin, const PushButtonHostEdge *edges, unsigned int count)
+	{
+		PinState &p = pinState(pin);
+		p.waveform = edges;
+		p.count = count;
+		rewind(pin);
+	}
+
+	/// <summary> Restarts the waveform attached to the pin from its first edge </summary>
+	/// <param name="pin"> The pin </param>
+	static void rewind(byte pin)
+	{
+		PinState &p = pinState(pin);
+		p.position = 0;
+		p.level = p.idleLevel;
+	}
+
+	/// <summary> Resets the virtual clock to 0 and all the pins to idle HIGH level without waveforms (analog inputs to 0) </summary>
+	static void reset()
+	{
+		clock() = 0;
+		for (unsigned int i = 0; i < YAPUSHBUTTON_HOST_PINS; i++)
+		{
+			PinState &p = pinState(i);
+			p.waveform = NULL;
+			p.count = p.position = 0;
+			p.level = p.idleLevel = HIGH;
+			p.analog = 0;
+		}
+	}
+
+private:
+	/// <summary> The state of a simulated pin </summary>
+	struct PinState
+	{
+		const PushButtonHostEdge *waveform;
+		unsigned int count;
+		unsigned int position;
+		byte level;
+		byte idleLevel;
+		int analog;
+	};
+
+	static unsigned long &clock()
+	{
+		static unsigned long t = 0;
+		return t;
+	}
+
+	static PinState &pinState(unsigned int pin)
+	{
+		static PinState pins[YAPUSHBUTTON_HOST_PINS] = { };
+		static bool initialized = false;
+		if (!initialized)
+		{
+			initialized = true;
+			for (unsigned int i = 0; i < YAPUSHBUTTON_HOST_PINS; i++)
+				pins[i].level = pins[i].idleLevel = HIGH;
+		}
+		return pins[pin % YAPUSHBUTTON_HOST_PINS];
+	}
+};
+
+#include "yaPushButton.h"
+
+#endif
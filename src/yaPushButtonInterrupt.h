@@ -0,0 +1,180 @@
+// yaPushButtonInterrupt.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// interrupt driven edge capture - the pin change interrupt only timestamps the edges,
+// debouncing is done lazily in the main loop when the captured edges are processed
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONINTERRUPT_h
+#define _YAPUSHBUTTONINTERRUPT_h
+
+#include "yaPushButton.h"
+#include "yaPushButtonRingBuffer.h"
+
+/// <summary> An edge captured by the interrupt handler </summary>
+/// <remarks> T is the time type of the HAL </remarks>
+template < typename T >
+struct PushButtonEdge
+{
+	/// <summary> the time the edge has been captured </summary>
+	T time;
+	/// <summary> the state of the button after the edge (true - pressed) </summary>
+	bool pressed;
+};
+
+/// <summary>
+/// PushButtonInterrupt Template Class
+/// </summary>
+/// <remarks>
+/// Implements a push button with debouncing where the edges are captured by an interrupt handler
+/// ACT determines active low = false (default)
+/// - push button that connects to GND when pressed
+/// or active high push button
+/// N is the size of the edge buffer (power of 2, holds N-1 edges)
+/// captureEdge() has to be called from the pin change (CHANGE) interrupt handler of the pin,
+/// it only records the time and the state of the button in a lock-free ring buffer.
+/// stateChanged() processes the recorded edges using the same debounce rules as PushButton,
+/// but with the times the edges actually happened, so no press is lost even if
+/// stateChanged() is not called for a long time (as long as the buffer does not overflow)
+/// and stateChanged() costs next to nothing while there are no edges
+/// If the buffer overflows the state of the button is re-read when the buffer is emptied
+/// </remarks>
+template < bool ACT = false, class HAL = YAPUSHBUTTON_DEFAULT_HAL, byte N = 16 >
+class PushButtonInterrupt : public PushButton<ACT, HAL>
+{
+	using PushButton<ACT, HAL>::debounceWaiting;
+	using PushButton<ACT, HAL>::stateChangedTimeStamp;
+	using PushButton<ACT, HAL>::debounceDelay;
+	using PushButton<ACT, HAL>::previousButtonState;
+
+public:
+	/// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	typedef typename PushButton<ACT, HAL>::time_type time_type;
+
+protected:
+	/// <summary> the edges captured by the interrupt handler, not processed yet </summary>
+	PushButtonRingBuffer<PushButtonEdge<time_type>, N> edges;
+	/// <summary> set by the interrupt handler when an edge had to be dropped </summary>
+	volatile bool overflow;
+	/// <summary> the (not debounced) state of the button after the last processed edge </summary>
+	bool rawState;
+
+public:
+	/// <summary> PushButtonInterrupt constructor </summary>
+	/// <param name="pbPin"> The pin the button is connected to </param>
+	/// <param name="DebounceDelay"> The delay in milliseconds for debouncing </param>
+	PushButtonInterrupt(byte pbPin, unsigned long DebounceDelay = 50) :
+		PushButton<ACT, HAL>(pbPin, DebounceDelay), overflow(false), rawState(false)
+	{ }
+
+	/// <summary> initializes the PushButtonInterrupt object </summary>
+	/// <remarks> has to be called before the interrupt handler is attached </remarks>
+	void init()
+	{
+		PushButton<ACT, HAL>::init();
+		edges.clear();
+		rawState = false;
+		overflow = this->isPressed(); // if already pressed let the state be picked up as an edge
+	}
+
+	/// <summary> Captures an edge, to be called from the pin change interrupt handler </summary>
+	void captureEdge()
+	{
+		PushButtonEdge<time_type> e;
+		e.time = HAL::now();
+		e.pressed = this->isPressed();
+		if (!edges.push(e))
+			overflow = true;
+	}
+
+	/// <summary> Are there captured edges not processed yet or debouncing in progress </summary>
+	/// <returns> true if stateChanged() has work to do </returns>
+	bool pending() const
+	{
+		return debounceWaiting || !edges.empty() || overflow;
+	}
+
+	/// <summary> The time until stateChanged() has work to do unless another edge is captured </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> 0 if there are captured edges to process, the time in HAL ticks until the debounce period 
+	/// expires while debouncing, otherwise maxTime() </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		if (!edges.empty() || overflow)
+			return 0;
+		return PushButton<ACT, HAL>::nextEventIn(now);
+	}
+
+	/// <summary> Is the button idle - released with no captured edges to process </summary>
+	/// <returns> true if only a new edge can produce the next event </returns>
+	bool isIdle() const
+	{
+		return PushButton<ACT, HAL>::isIdle() && edges.empty() && !overflow;
+	}
+
+	/// <summary> Detect state change of a button </summary>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	/// <remark> processes the captured edges, returns BUTTON_PRESSED or BUTTON_RELEASED
+	/// once the state of the button has been stable for the debounce time after an edge
+	/// If several state changes have been captured since the last call, they are returned
+	/// one per call in the order they happened.
+	/// To be called repeatedly in a loop </remark>
+	byte stateChanged()
+	{
+		return stateChanged(HAL::now());
+	}
+
+	/// <summary> Detect state change of a button at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	byte stateChanged(time_type now)
+	{
+		PushButtonEdge<time_type> e;
+		for (;;)
+		{
+			if (debounceWaiting) // are we waiting for the debounce period to pass?
+			{
+				bool more = edges.peek(e);
+				if (more && (time_type)(e.time - stateChangedTimeStamp) <= debounceDelay) // bounce within the debounce period
+				{
+					rawState = e.pressed;
+					this->statsSample(rawState);
+					edges.pop();
+					continue;
+				}
+				time_type waited = (time_type)(now - stateChangedTimeStamp); // "negative" if the edge came after now was sampled
+				if (!more && (waited <= debounceDelay || waited > (((time_type)~(time_type)0) >> 1))) // still waiting
+					return BUTTON_NOCHANGE;
+				// the debounce period has passed (before the next edge if there is one)
+				debounceWaiting = false;
+				if (previousButtonState ^ rawState)
+				{
+					byte r = (previousButtonState << 1) | rawState;
+					this->statsReport(now, r);
+					previousButtonState = rawState;
+					return r;
+				}
+			}
+			else // !debounceWaiting
+			{
+				if (!edges.pop(e))
+				{
+					if (!overflow) // nothing happened
+						return BUTTON_NOCHANGE;
+					// edges have been lost - continue from the current state
+					overflow = false;
+					e.time = now;
+					e.pressed = this->isPressed();
+				}
+				rawState = e.pressed;
+				this->statsSample(rawState);
+				if (previousButtonState ^ rawState) // a state change - start waiting to stabilize
+				{
+					debounceWaiting = true;
+					stateChangedTimeStamp = e.time;
+				}
+			}
+		}
+	}
+};
+
+#endif
@@ -0,0 +1,184 @@
+// yaPushButtonLadder.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// several buttons on one analog input through a resistor ladder - the ADC is read once per scan
+// and the level classified into the button pressed by a binary search in a threshold table
+// computed at compile time, the buttons are then debounced and autorepeated by the usual classes
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONLADDER_h
+#define _YAPUSHBUTTONLADDER_h
+
+#include "yaPushButton.h"
+
+/// <summary> Index list for generating the threshold tables </summary>
+template < byte... I >
+struct PushButtonLadderIndices
+{ };
+
+/// <summary> Builds the index list 0 .. N-1 </summary>
+template < byte N, byte... I >
+struct PushButtonLadderBuild : PushButtonLadderBuild<N - 1, N - 1, I...>
+{ };
+template < byte... I >
+struct PushButtonLadderBuild<0, I...>
+{
+	typedef PushButtonLadderIndices<I...> type;
+};
+
+/// <summary> The ADC levels of a ladder as a compile-time list </summary>
+template < uint16_t... L >
+struct PushButtonLadderList;
+template < uint16_t F, uint16_t... R >
+struct PushButtonLadderList<F, R...>
+{
+	/// <summary> The level i of the list </summary>
+	static constexpr uint16_t at(byte i)
+	{
+		return i == 0 ? F : PushButtonLadderList<R...>::at(i - 1);
+	}
+	/// <summary> Are the levels from i on in ascending order </summary>
+	static constexpr bool ascending()
+	{
+		return PushButtonLadderList<R...>::ascending() && (sizeof...(R) == 0 || F < PushButtonLadderList<R...>::at(0));
+	}
+};
+template < >
+struct PushButtonLadderList<>
+{
+	static constexpr uint16_t at(byte)
+	{
+		return 0;
+	}
+	static constexpr bool ascending()
+	{
+		return true;
+	}
+};
+
+/// <summary>
+/// PushButtonLadderLevels Template Class
+/// </summary>
+/// <remarks>
+/// The threshold table of a resistor ladder - LEVELS are the ADC readings of the buttons (button 0 first)
+/// in ascending order and IDLE (the highest) the reading with no button pressed
+/// The thresholds are the midpoints between the neighbouring levels, computed at compile time
+/// PushButtonLadderLevels&lt;1023, 0, 144, 329, 504, 741&gt; - the five buttons of the common LCD keypad shield
+/// </remarks>
+template < uint16_t IDLE, uint16_t... LEVELS >
+struct PushButtonLadderLevels
+{
+	static_assert(sizeof...(LEVELS) >= 1 && sizeof...(LEVELS) < 32, "a ladder has 1 to 31 buttons");
+	static_assert(PushButtonLadderList<LEVELS..., IDLE>::ascending(), "the levels have to be ascending, IDLE the highest");
+
+	/// <summary> the number of buttons on the ladder </summary>
+	static const byte buttons = sizeof...(LEVELS);
+
+	/// <summary> The threshold between the level i and the next one (i + 1 or IDLE) </summary>
+	static constexpr uint16_t threshold(byte i)
+	{
+		return (uint16_t)(((unsigned long)PushButtonLadderList<LEVELS..., IDLE>::at(i) + PushButtonLadderList<LEVELS..., IDLE>::at(i + 1) + 1) / 2);
+	}
+
+	/// <summary> The table of the thresholds </summary>
+	template < class = typename PushButtonLadderBuild<sizeof...(LEVELS)>::type >
+	struct Table;
+	template < byte... I >
+	struct Table< PushButtonLadderIndices<I...> >
+	{
+		static const uint16_t thresholds[sizeof...(LEVELS)];
+	};
+};
+
+template < uint16_t IDLE, uint16_t... LEVELS >
+template < byte... I >
+const uint16_t PushButtonLadderLevels<IDLE, LEVELS...>::Table< PushButtonLadderIndices<I...> >::thresholds[sizeof...(LEVELS)] =
+	{ PushButtonLadderLevels<IDLE, LEVELS...>::threshold(I)... };
+
+/// <summary>
+/// PushButtonLadderHAL Template Class
+/// </summary>
+/// <remarks>
+/// Hardware access policy for the buttons of a resistor ladder on the analog input CHANNEL,
+/// LADDER is its threshold table (PushButtonLadderLevels), the time comes from the BASE policy
+/// update() (once per scan, before the buttons are serviced) reads the ADC once and classifies
+/// the level into the button pressed - a binary search in the thresholds, integers only
+/// The pin of a button is its index on the ladder, it reads LOW while the button is the one pressed
+/// (so the buttons are active low), the ladder reads one button at a time
+/// The levels passed through while a button is pressed or released are filtered by the debounce of the buttons
+/// </remarks>
+template < class LADDER, byte CHANNEL, class BASE = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonLadderHAL : public BASE
+{
+	/// <summary> the thresholds </summary>
+	typedef typename LADDER::template Table<> thresholds_type;
+
+public:
+	/// <summary> the number of buttons on the ladder (the value of pressed() when none is) </summary>
+	static const byte buttons = LADDER::buttons;
+
+	/// <summary> Classifies an ADC reading </summary>
+	/// <param name="level"> The ADC reading </param>
+	/// <returns> the button pressed, buttons if none </returns>
+	static byte classify(uint16_t level)
+	{
+		byte lo = 0, hi = buttons; // the first threshold above the level
+		while (lo < hi)
+		{
+			byte mid = (byte)((lo + hi) / 2);
+			if (level < thresholds_type::thresholds[mid])
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	/// <summary> Reads the ADC and classifies the level </summary>
+	/// <remark> to be called once per scan, before the buttons are serviced </remark>
+	static void update()
+	{
+		state().level = (uint16_t)BASE::readAnalog(CHANNEL);
+		state().pressed = classify(state().level);
+	}
+
+	/// <summary> The button pressed on the last update() </summary>
+	/// <returns> the index of the button, buttons if none </returns>
+	static byte pressed()
+	{
+		return state().pressed;
+	}
+
+	/// <summary> The ADC reading of the last update() </summary>
+	static uint16_t level()
+	{
+		return state().level;
+	}
+
+	/// <summary> Reads the button </summary>
+	/// <param name="pin"> The index of the button on the ladder </param>
+	/// <returns> LOW if the button is pressed, otherwise HIGH </returns>
+	static int readPin(byte pin)
+	{
+		return state().pressed == pin ? LOW : HIGH;
+	}
+
+	/// <summary> The buttons need no configuration (the analog input is an input by default) </summary>
+	static void setupPin(byte, byte)
+	{ }
+
+private:
+	/// <summary> The last reading </summary>
+	struct State
+	{
+		uint16_t level;
+		byte pressed;
+	};
+
+	static State &state()
+	{
+		static State s = { 0, buttons };
+		return s;
+	}
+};
+
+#endif
@@ -0,0 +1,595 @@
+// yaPushButtonMatrix.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// scans a keypad matrix - one row driven at a time, all the columns read as one word
+// every key gets the debounce policy and the autorepeat schedule of PushButtonAutoRepeat with its 
+// state packed into bits of the row words and one timestamp, ghosting and rollover are detected
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONMATRIX_h
+#define _YAPUSHBUTTONMATRIX_h
+
+#include "yaPushButton.h"
+
+/// <summary> Selects the smallest unsigned type with a bit for each of the COLS columns (up to 32) </summary>
+template < byte COLS, bool WIDE = (COLS > 8), bool WIDER = (COLS > 16) >
+struct PushButtonMatrixWord
+{
+	typedef byte type;
+};
+template < byte COLS >
+struct PushButtonMatrixWord<COLS, true, false>
+{
+	typedef uint16_t type;
+};
+template < byte COLS >
+struct PushButtonMatrixWord<COLS, true, true>
+{
+	typedef uint32_t type;
+};
+
+/// <summary> The debounce policies of the N keys of a matrix - an instance of DEBOUNCER for each key </summary>
+template < template < typename > class DEBOUNCER, typename T, byte N >
+class PushButtonMatrixDebouncers
+{
+public:
+	/// <summary> The policy of a key (its functions made accessible to the matrix) </summary>
+	struct Key : public DEBOUNCER<T>
+	{
+		using DEBOUNCER<T>::debounceStart;
+		using DEBOUNCER<T>::debounceSettled;
+		using DEBOUNCER<T>::debounceNextIn;
+	};
+
+	Key &operator[](byte key)
+	{
+		return keys[key];
+	}
+	const Key &operator[](byte key) const
+	{
+		return keys[key];
+	}
+
+private:
+	Key keys[N];
+};
+
+/// <summary> The time window keeps no state - one instance serves all the keys </summary>
+template < typename T, byte N >
+class PushButtonMatrixDebouncers<PushButtonTimeWindow, T, N>
+{
+public:
+	struct Key : public PushButtonTimeWindow<T>
+	{
+		using PushButtonTimeWindow<T>::debounceStart;
+		using PushButtonTimeWindow<T>::debounceSettled;
+		using PushButtonTimeWindow<T>::debounceNextIn;
+	};
+
+	Key &operator[](byte)
+	{
+		return window;
+	}
+	const Key &operator[](byte) const
+	{
+		return window;
+	}
+
+private:
+	Key window;
+};
+
+/// <summary>
+/// PushButtonMatrix Template Class
+/// </summary>
+/// <remarks>
+/// Scans a keypad of ROWS x COLS keys (a key connects its row to its column when pressed)
+/// The selected row is driven LOW (OUTPUT), the others are left floating (INPUT), so pressing
+/// several keys cannot short two driven rows; the columns are pulled up (INPUT_PULLUP) and read
+/// pin by pin, or all at once with a user supplied function (for example returning PINC),
+/// after the settle time (setSettleTime(), 0 by default) - for long wires or a fast column read
+/// The keys are numbered row * COLS + column
+/// Each key is debounced by the DEBOUNCER policy like PushButton and its state is kept packed - 
+/// a bit in the debounced and in the debouncing row words, plus one timestamp (1 byte per key with 
+/// PushButtonTicksHAL&lt;uint8_t&gt;) and the state of the policy (none for the default PushButtonTimeWindow)
+/// Autorepeat follows the schedule of PushButtonAutoRepeat (PushButtonRepeatSchedule) for the key pressed last,
+/// as on a PC keyboard - pressing another key takes over, releasing it stops the autorepeat
+/// Ghosting - without diodes three pressed corners of a rectangle make the fourth read as pressed;
+/// while the keys read form such a rectangle the keys in it cannot be pressed (ghosting() is set),
+/// the keys already down are kept. The rollover limit stops new presses while that many keys are down
+/// A scan costs ROWS row selections and column reads, ROWS*(ROWS-1)/2 word ANDs for the ghost check
+/// and per key work only for the keys that differ from their debounced state or are being debounced
+/// </remarks>
+template < byte ROWS, byte COLS, class HAL = YAPUSHBUTTON_DEFAULT_HAL, template < typename > class DEBOUNCER = PushButtonTimeWindow >
+class PushButtonMatrix
+{
+	static_assert(ROWS >= 1 && COLS >= 1 && COLS <= 32, "PushButtonMatrix supports up to 32 columns");
+	static_assert((unsigned int)ROWS * COLS < 255, "PushButtonMatrix supports up to 254 keys");
+
+public:
+	/// <summary> the type the timestamps and delays are kept in (HAL ticks) </summary>
+	typedef typename HAL::time_type time_type;
+	/// <summary> the type of a row word - a bit for each column </summary>
+	typedef typename PushButtonMatrixWord<COLS>::type word_type;
+	/// <summary> the number of keys </summary>
+	static const byte keys = ROWS * COLS;
+	/// <summary> returned as key when there is none </summary>
+	static const byte noKey = 0xFF;
+
+protected:
+// configuration
+	/// <summary> the pins the rows are connected to </summary>
+	const byte *rowPins;
+	/// <summary> the pins the columns are connected to </summary>
+	const byte *colPins;
+	/// <summary> the function reading the levels of all the columns at once (bit c for column c), NULL - read pin by pin </summary>
+	word_type(*readColumns)();
+	/// <summary> the time for debouncing </summary>
+	time_type debounceDelay;
+	/// <summary> the delay before autorepeat begins </summary>
+	time_type repeatDelay;
+	/// <summary> the auto repeating period </summary>
+	time_type repeatPeriod;
+	/// <summary> the function to be called on each keypress event with the context, the key and the event (if set) </summary>
+	void(*keyEventCallback)(void *context, byte key, ButtonEvent event);
+	/// <summary> the context passed to keyEventCallback </summary>
+	void *callbackContext;
+	/// <summary> the most keys down at once (0 - no limit) </summary>
+	byte rollover;
+	/// <summary> the time in microseconds the driven row is left to settle before the columns are read </summary>
+	byte settleTime;
+	/// <summary> the catch-up policy of the autorepeat (ButtonCatchUp) </summary>
+	byte catchUp : 2;
+	/// <summary> block the keys of a ghost rectangle (off for keypads with diodes) </summary>
+	bool ghostBlocking : 1;
+
+// operation
+	/// <summary> is the ghost check blocking keys on the last scan </summary>
+	bool ghostSeen : 1;
+	/// <summary> have presses been stopped by the rollover limit on the last scan </summary>
+	bool rolloverSeen : 1;
+	/// <summary> the debounced state of the keys (bit set while pressed) </summary>
+	word_type downMask[ROWS];
+	/// <summary> the keys waiting for the debounce time to pass </summary>
+	word_type waitingMask[ROWS];
+	/// <summary> the keys whose debounced state changed on the last scan </summary>
+	word_type changedMask[ROWS];
+	/// <summary> the time the state change of the key was spotted (kept while the key is held - the press time) </summary>
+	time_type stateChangedTimeStamp[ROWS * COLS];
+	/// <summary> the debounce policies of the keys </summary>
+	PushButtonMatrixDebouncers<DEBOUNCER, time_type, ROWS * COLS> debouncers;
+	/// <summary> the number of keys down </summary>
+	byte downCount;
+	/// <summary> the autorepeating key (noKey if none) </summary>
+	byte repeatKey;
+	/// <summary> the time of the first keypress, then the tick before the last autorepeated keypress was due </summary>
+	time_type lastChangeTime;
+	/// <summary> the number of keypresses autorepeated since the key has been pressed </summary>
+	unsigned int repeatCount;
+
+	/// <summary> The mask of all the columns </summary>
+	static word_type columnMask()
+	{
+		return (word_type)((word_type)~(word_type)0 >> (sizeof(word_type) * 8 - COLS));
+	}
+
+	/// <summary> Selects a row and reads the columns </summary>
+	/// <param name="row"> The row </param>
+	/// <returns> bit set for each key of the row that reads pressed </returns>
+	word_type readRow(byte row)
+	{
+		HAL::writePin(rowPins[row], LOW); // before switching to output, so the row is never driven HIGH
+		HAL::setupPin(rowPins[row], OUTPUT);
+		HAL::writePin(rowPins[row], LOW); // again for the cores that reset the output level in pinMode()
+		if (settleTime)
+			HAL::delayMicros(settleTime);
+		word_type levels;
+		if (readColumns)
+			levels = readColumns();
+		else
+		{
+			levels = 0;
+			for (byte c = 0; c < COLS; c++)
+				if (HAL::readPin(colPins[c]))
+					levels |= (word_type)1 << c;
+		}
+		HAL::setupPin(rowPins[row], INPUT);
+		return (word_type)(~levels & columnMask());
+	}
+
+	/// <summary> Makes the event for the next keypress and counts the repeats </summary>
+	ButtonEvent nextEvent(byte kind, unsigned int count = 1)
+	{
+		if (kind == BUTTON_EVENT_PRESS)
+			repeatCount = 0;
+		else
+			repeatCount += count;
+		ButtonEvent e;
+		e.kind = kind;
+		e.repeatIndex = repeatCount;
+		e.count = count;
+		return e;
+	}
+
+	/// <summary> Fires the autorepeated keypresses of the repeating key due at the given time </summary>
+	/// <remarks> the schedule and catch-up of PushButtonAutoRepeat (PushButtonRepeatSchedule) </remarks>
+	template < class F >
+	void repeat(time_type now, F &f)
+	{
+		typedef PushButtonRepeatSchedule<time_type> Schedule;
+		time_type late;
+		time_type held = Schedule::held(now, stateChangedTimeStamp[repeatKey]);
+		typename Schedule::Steady steps = { repeatPeriod, BUTTON_EVENT_REPEAT };
+		Schedule::run(now, held, repeatDelay, lastChangeTime, late, catchUp, steps,
+			[&](byte kind, unsigned int count) { f(repeatKey, nextEvent(kind, count)); });
+	}
+
+	/// <summary> Functor calling the registered callback function (used by handle(now)) </summary>
+	struct Callback
+	{
+		PushButtonMatrix *matrix;
+		void operator()(byte key, ButtonEvent event) const
+		{
+			if (matrix->keyEventCallback)
+				matrix->keyEventCallback(matrix->callbackContext, key, event);
+		}
+	};
+
+public:
+	/// <summary> PushButtonMatrix constructor </summary>
+	/// <param name="RowPins"> The ROWS pins the rows are connected to (not copied) </param>
+	/// <param name="ColPins"> The COLS pins the columns are connected to (not copied) </param>
+	/// <param name="RepeatDelay"> The delay in milliseconds before autorepeat begins </param>
+	/// <param name="AutoRepeatingPeriod"> The period in milliseconds at which a new keypress will be automatically produced </param>
+	/// <param name="DebounceDelay"> The delay in milliseconds for debouncing </param>
+	PushButtonMatrix(const byte *RowPins, const byte *ColPins,
+		unsigned long RepeatDelay = 500, unsigned long AutoRepeatingPeriod = 200, unsigned long DebounceDelay = 20) :
+		rowPins(RowPins), colPins(ColPins), readColumns(NULL), debounceDelay(PushButton<false, HAL>::delayTicks(DebounceDelay)),
+		repeatDelay(PushButton<false, HAL>::delayTicks(RepeatDelay)), repeatPeriod(PushButton<false, HAL>::delayTicks(AutoRepeatingPeriod)),
+		keyEventCallback(NULL), callbackContext(NULL), rollover(0), settleTime(0)
+	{
+		catchUp = BUTTON_CATCHUP_SKIP;
+		ghostBlocking = true;
+		reset();
+	}
+
+	/// <summary> initializes the PushButtonMatrix object - configures the pins, all the keys released </summary>
+	void init()
+	{
+		for (byte r = 0; r < ROWS; r++)
+			HAL::setupPin(rowPins[r], INPUT);
+		for (byte c = 0; c < COLS; c++)
+			HAL::setupPin(colPins[c], INPUT_PULLUP);
+		reset();
+	}
+
+	/// <summary> Sets all the keys released (without touching the pins) </summary>
+	void reset()
+	{
+		for (byte r = 0; r < ROWS; r++)
+			downMask[r] = waitingMask[r] = changedMask[r] = 0;
+		downCount = 0;
+		repeatKey = noKey;
+		lastChangeTime = 0;
+		repeatCount = 0;
+		ghostSeen = rolloverSeen = false;
+	}
+
+	/// <summary> Sets the function reading all the columns at once </summary>
+	/// <param name="ReadColumns"> Returns the levels of the columns, bit c for column c (NULL - read the column pins one by one) </param>
+	void setColumnReader(word_type(*ReadColumns)())
+	{
+		readColumns = ReadColumns;
+	}
+
+	/// <summary> Sets the time the driven row is left to settle before the columns are read </summary>
+	/// <param name="us"> The time in microseconds (0 - read at once, default) </param>
+	/// <remark> long wires to the keypad or reading all the columns right after the row is driven may need a few microseconds </remark>
+	void setSettleTime(byte us)
+	{
+		settleTime = us;
+	}
+
+	/// <summary> Gets the time the driven row is left to settle before the columns are read </summary>
+	/// <returns> the time in microseconds </returns>
+	byte getSettleTime() const
+	{
+		return settleTime;
+	}
+
+	/// <summary> Registers the callback function to be called on each keypress with a context, the key and the event </summary>
+	/// <param name="keyEventFunction"> The function to be called on each keypress </param>
+	/// <param name="context"> The pointer passed to the function </param>
+	void registerKeyEventCallback(void(*keyEventFunction)(void *, byte, ButtonEvent), void *context)
+	{
+		keyEventCallback = keyEventFunction;
+		callbackContext = context;
+	}
+
+	/// <summary> Sets the debouncing delay </summary>
+	/// <param name="delay"> The delay in milliseconds for debouncing </param>
+	void setDebounceDelay(unsigned long delay)
+	{
+		debounceDelay = PushButton<false, HAL>::delayTicks(delay);
+	}
+
+	/// <summary> Gets the debouncing delay </summary>
+	/// <returns> the debouncing delay in milliseconds </returns>
+	unsigned long getDebounceDelay() const
+	{
+		return HAL::toMillis(debounceDelay);
+	}
+
+	/// <summary> Sets the delay the key has to be hold pressed before autorepeat starts </summary>
+	/// <param name="RepeatDelay"> The delay in milliseconds before autorepeat begins </param>
+	void setRepeatDelay(unsigned long RepeatDelay)
+	{
+		repeatDelay = PushButton<false, HAL>::delayTicks(RepeatDelay);
+	}
+
+	/// <summary> Gets the delay the key has to be hold pressed before autorepeat starts </summary>
+	/// <returns> The delay in milliseconds before autorepeat begins </returns>
+	unsigned long getRepeatDelay() const
+	{
+		return HAL::toMillis(repeatDelay);
+	}
+
+	/// <summary> Sets the period at which a new keypress will be automatically produced (0 - every scan) </summary>
+	/// <param name="AutoRepeatingPeriod"> The period in milliseconds </param>
+	void setRepeatPeriod(unsigned long AutoRepeatingPeriod)
+	{
+		repeatPeriod = PushButton<false, HAL>::delayTicks(AutoRepeatingPeriod);
+	}
+
+	/// <summary> Gets the period at which a new keypress will be automatically produced </summary>
+	/// <returns> The period in milliseconds </returns>
+	unsigned long getRepeatPeriod() const
+	{
+		return HAL::toMillis(repeatPeriod);
+	}
+
+	/// <summary> Sets what is fired when handle() is called too late for more than one autorepeated keypress </summary>
+	/// <param name="policy"> BUTTON_CATCHUP_SKIP (default), BUTTON_CATCHUP_BURST or BUTTON_CATCHUP_COUNT </param>
+	void setCatchUp(byte policy)
+	{
+		catchUp = policy;
+	}
+
+	/// <summary> Gets the catch-up policy </summary>
+	/// <returns> BUTTON_CATCHUP_SKIP, BUTTON_CATCHUP_BURST or BUTTON_CATCHUP_COUNT </returns>
+	byte getCatchUp() const
+	{
+		return catchUp;
+	}
+
+	/// <summary> Sets the most keys that can be down at once </summary>
+	/// <param name="keys"> The number of keys (0 - no limit, default) </param>
+	/// <remark> a key pressed while that many keys are down is not reported until one of them is released </remark>
+	void setRollover(byte keys)
+	{
+		rollover = keys;
+	}
+
+	/// <summary> Turns the blocking of the keys of ghost rectangles on or off </summary>
+	/// <param name="on"> true (default) for keypads without diodes, false for keypads with a diode on every key </param>
+	void setGhostBlocking(bool on)
+	{
+		ghostBlocking = on;
+	}
+
+	/// <summary> Has the last scan seen the keys forming a ghost rectangle </summary>
+	/// <returns> true if some keys could not be told apart from ghosts (their presses are held back) </returns>
+	bool ghosting() const
+	{
+		return ghostSeen;
+	}
+
+	/// <summary> Has the last scan held back a press because of the rollover limit </summary>
+	/// <returns> true if a key has been pressed while the most keys were down </returns>
+	bool rolloverExceeded() const
+	{
+		return rolloverSeen;
+	}
+
+	/// <summary> Scans the matrix, debounces the keys and services the autorepeat </summary>
+	/// <remark> To be called repeatedly in a loop, the keypresses are reported to the registered callback </remark>
+	void handle()
+	{
+		handle(HAL::now());
+	}
+
+	/// <summary> Scans the matrix at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(time_type now)
+	{
+		Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Scans the matrix at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the key and the ButtonEvent on each keypress </param>
+	/// <remark> the releases are not reported as keypresses - see released() and stateChanged() </remark>
+	template < class F >
+	void handle(time_type now, F &&f)
+	{
+		word_type raw[ROWS];
+		for (byte r = 0; r < ROWS; r++)
+			raw[r] = readRow(r);
+
+		ghostSeen = rolloverSeen = false;
+		if (ghostBlocking) // two rows sharing two columns - any of the four keys can be a ghost
+		{
+			word_type blocked[ROWS];
+			for (byte r = 0; r < ROWS; r++)
+				blocked[r] = 0;
+			for (byte r1 = 0; r1 + 1 < ROWS; r1++)
+				for (byte r2 = r1 + 1; r2 < ROWS; r2++)
+				{
+					word_type shared = (word_type)(raw[r1] & raw[r2]);
+					if (shared & (word_type)(shared - 1)) // more than one bit
+					{
+						blocked[r1] |= shared;
+						blocked[r2] |= shared;
+						ghostSeen = true;
+					}
+				}
+			if (ghostSeen)
+				for (byte r = 0; r < ROWS; r++) // the blocked keys stay as they are
+					raw[r] = (word_type)((raw[r] & ~blocked[r]) | (downMask[r] & blocked[r]));
+		}
+
+		for (byte r = 0; r < ROWS; r++)
+		{
+			changedMask[r] = 0;
+			word_type active = (word_type)((raw[r] ^ downMask[r]) | waitingMask[r]);
+			for (byte c = 0; active; c++, active >>= 1)
+			{
+				if (!(active & 1))
+					continue;
+				const word_type bit = (word_type)1 << c;
+				const byte key = r * COLS + c;
+				bool current = raw[r] & bit;
+				bool down = downMask[r] & bit;
+				if (!(waitingMask[r] & bit)) // a state change spotted
+				{
+					waitingMask[r] |= bit;
+					stateChangedTimeStamp[key] = now;
+					debouncers[key].debounceStart(now, current);
+				}
+				else if (debouncers[key].debounceSettled(now, current, stateChangedTimeStamp[key], debounceDelay)) // been waiting long enough
+				{
+					waitingMask[r] &= ~bit;
+					if (current == down)
+						continue;
+					if (current)
+					{
+						if (rollover && downCount >= rollover)
+						{
+							rolloverSeen = true;
+							continue;
+						}
+						downCount++;
+						repeatKey = key;
+						lastChangeTime = now;
+						f(key, nextEvent(BUTTON_EVENT_PRESS));
+					}
+					else
+					{
+						downCount--;
+						if (repeatKey == key)
+							repeatKey = noKey;
+					}
+					downMask[r] ^= bit;
+					changedMask[r] |= bit;
+				}
+			}
+		}
+		if (repeatKey != noKey)
+			repeat(now, f);
+	}
+
+	/// <summary> Is the key (held) pressed (debounced) </summary>
+	/// <param name="key"> The key (row * COLS + column) </param>
+	/// <returns> true while the key is pressed </returns>
+	bool isDown(byte key) const
+	{
+		return (downMask[key / COLS] >> (key % COLS)) & 1;
+	}
+
+	/// <summary> State change of a key on the last scan </summary>
+	/// <param name="key"> The key (row * COLS + column) </param>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	byte stateChanged(byte key) const
+	{
+		if (!((changedMask[key / COLS] >> (key % COLS)) & 1))
+			return BUTTON_NOCHANGE;
+		return isDown(key) ? BUTTON_PRESSED : BUTTON_RELEASED;
+	}
+
+	/// <summary> The debounced state of a row </summary>
+	/// <param name="row"> The row </param>
+	/// <returns> bit set for each key of the row being (held) pressed </returns>
+	word_type state(byte row) const
+	{
+		return downMask[row];
+	}
+
+	/// <summary> The keys of a row that have been pressed on the last scan </summary>
+	/// <param name="row"> The row </param>
+	/// <returns> bit set for each key that has just been pressed </returns>
+	word_type pressed(byte row) const
+	{
+		return changedMask[row] & downMask[row];
+	}
+
+	/// <summary> The keys of a row that have been released on the last scan </summary>
+	/// <param name="row"> The row </param>
+	/// <returns> bit set for each key that has just been released </returns>
+	word_type released(byte row) const
+	{
+		return changedMask[row] & (word_type)~downMask[row];
+	}
+
+	/// <summary> The number of keys down </summary>
+	/// <returns> the number of keys (debounced) pressed </returns>
+	byte keysDown() const
+	{
+		return downCount;
+	}
+
+	/// <summary> The autorepeating key </summary>
+	/// <returns> the key pressed last if still held, otherwise noKey </returns>
+	byte getRepeatKey() const
+	{
+		return repeatKey;
+	}
+
+	/// <summary> For how long the autorepeating key has been held pressed </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks (0 if no key is held) </returns>
+	time_type heldDown(time_type now) const
+	{
+		return repeatKey == noKey ? 0 : (time_type)(now - stateChangedTimeStamp[repeatKey]);
+	}
+
+	/// <summary> Are all the keys released and none being debounced </summary>
+	/// <returns> true if only pressing a key can produce the next event </returns>
+	bool isIdle() const
+	{
+		for (byte r = 0; r < ROWS; r++)
+			if (downMask[r] | waitingMask[r])
+				return false;
+		return true;
+	}
+
+	/// <summary> The time until the next event the matrix can produce unless a key changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until a debounce period expires or the next autorepeat keypress (0 if due),
+	/// or the maximum value of time_type if only a press or release can produce the next event </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		time_type next = PushButton<false, HAL>::maxTime();
+		for (byte r = 0; r < ROWS; r++)
+		{
+			word_type w = waitingMask[r];
+			for (byte c = 0; w; c++, w >>= 1)
+				if (w & 1)
+				{
+					time_type t = debouncers[r * COLS + c].debounceNextIn(now, stateChangedTimeStamp[r * COLS + c], debounceDelay);
+					if (t < next)
+						next = t;
+				}
+		}
+		if (repeatKey != noKey)
+		{
+			time_type toDelay = PushButton<false, HAL>::untilElapsed(now, stateChangedTimeStamp[repeatKey], repeatDelay);
+			time_type toPeriod = PushButton<false, HAL>::untilElapsed(now, lastChangeTime, repeatPeriod);
+			time_type t = toDelay > toPeriod ? toDelay : toPeriod;
+			if (t < next)
+				next = t;
+		}
+		return next;
+	}
+};
+
+#endif
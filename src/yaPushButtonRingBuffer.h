@@ -0,0 +1,127 @@
+// yaPushButtonRingBuffer.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// fixed size lock-free single-producer / single-consumer ring buffer
+// used to pass events from interrupt handlers to the main loop without disabling interrupts
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONRINGBUFFER_h
+#define _YAPUSHBUTTONRINGBUFFER_h
+
+#include "yaPushButton.h"
+
+// keeps the compiler (and the CPU on multi-core targets) from reordering the writing of an
+// element and the publishing of the index - single core AVR needs only a compiler barrier
+#if defined(__AVR__)
+#define YAPUSHBUTTON_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+#define YAPUSHBUTTON_BARRIER() __sync_synchronize()
+#endif
+
+/// <summary>
+/// PushButtonRingBuffer Template Class
+/// </summary>
+/// <remarks>
+/// Lock-free ring buffer for exactly one producer (for example an interrupt handler)
+/// and one consumer (the main loop) holding up to N-1 elements of type T
+/// N has to be a power of 2, not greater than 128 - the indices are single bytes
+/// so they are read and written atomically even on 8-bit MCUs
+/// push() may only be called by the producer, pop(), peek() and clear() only by the consumer
+/// </remarks>
+template < typename T, byte N = 16 >
+class PushButtonRingBuffer
+{
+	static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "PushButtonRingBuffer size has to be a power of 2 between 2 and 128");
+
+protected:
+	/// <summary> the elements </summary>
+	T buffer[N];
+	/// <summary> where the next element will be written (changed by the producer only) </summary>
+	volatile byte head;
+	/// <summary> where the next element will be read from (changed by the consumer only) </summary>
+	volatile byte tail;
+
+public:
+	/// <summary> PushButtonRingBuffer constructor </summary>
+	PushButtonRingBuffer() : head(0), tail(0)
+	{ }
+
+	/// <summary> Appends an element (producer side) </summary>
+	/// <param name="v"> The element to be appended </param>
+	/// <returns> false if the buffer is full and the element has been dropped </returns>
+	bool push(const T &v)
+	{
+		byte h = head;
+		byte next = (h + 1) & (N - 1);
+		if (next == tail) // full
+			return false;
+		buffer[h] = v;
+		YAPUSHBUTTON_BARRIER(); // the element has to be in place before it is published
+		head = next;
+		return true;
+	}
+
+	/// <summary> Reads the oldest element without removing it (consumer side) </summary>
+	/// <param name="v"> Receives the element </param>
+	/// <returns> false if the buffer is empty </returns>
+	bool peek(T &v) const
+	{
+		byte t = tail;
+		if (t == head) // empty
+			return false;
+		YAPUSHBUTTON_BARRIER();
+		v = buffer[t];
+		return true;
+	}
+
+	/// <summary> Removes the oldest element (consumer side) </summary>
+	/// <param name="v"> Receives the element </param>
+	/// <returns> false if the buffer is empty </returns>
+	bool pop(T &v)
+	{
+		if (!peek(v))
+			return false;
+		YAPUSHBUTTON_BARRIER(); // the element has to be read before the slot is released
+		tail = (tail + 1) & (N - 1);
+		return true;
+	}
+
+	/// <summary> Removes the oldest element (consumer side) </summary>
+	/// <returns> false if the buffer is empty </returns>
+	bool pop()
+	{
+		byte t = tail;
+		if (t == head)
+			return false;
+		tail = (t + 1) & (N - 1);
+		return true;
+	}
+
+	/// <summary> Removes all the elements (consumer side) </summary>
+	void clear()
+	{
+		tail = head;
+	}
+
+	/// <summary> Is the buffer empty </summary>
+	/// <returns> true if there are no elements in the buffer </returns>
+	bool empty() const
+	{
+		return head == tail;
+	}
+
+	/// <summary> The number of elements in the buffer </summary>
+	/// <returns> the number of elements waiting to be read </returns>
+	byte count() const
+	{
+		return (head - tail) & (N - 1);
+	}
+
+	/// <summary> The maximum number of elements the buffer can hold </summary>
+	/// <returns> N - 1 </returns>
+	static byte capacity()
+	{
+		return N - 1;
+	}
+};
+
+#endif
@@ -0,0 +1,115 @@
+// yaPushButtonSleep.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// lets the MCU sleep between button events - collects the next deadline of all the
+// registered buttons and idles until it passes or a pin change wakes it up
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONSLEEP_h
+#define _YAPUSHBUTTONSLEEP_h
+
+#include "yaPushButton.h"
+
+/// <summary>
+/// PushButtonSleepManager Template Class
+/// </summary>
+/// <remarks>
+/// Keeps track of up to N buttons (any of the button classes, a PushButtonBank or a
+/// PushButtonInterrupt - anything with nextEventIn(now)) and computes the earliest time
+/// any of them can produce an event without its pin changing.
+/// sleep() idles the MCU (HAL::idle()) until that time, so handle() / stateChanged()
+/// is called only when there is something to do.
+/// A press or release while sleeping has to wake the loop - call wake() from the pin change
+/// interrupt handler of the buttons (or from PushButtonInterrupt::captureEdge() handler)
+/// The buttons are not copied, they have to outlive the manager
+/// </remarks>
+template < byte N = 8, class HAL = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonSleepManager
+{
+public:
+	/// <summary> the type the times are kept in (HAL ticks) </summary>
+	typedef typename HAL::time_type time_type;
+
+protected:
+	/// <summary> a registered button and the function that asks it for its next deadline </summary>
+	struct Entry
+	{
+		const void *button;
+		time_type(*nextEventIn)(const void *button, time_type now);
+	};
+
+	/// <summary> the registered buttons </summary>
+	Entry buttons[N];
+	/// <summary> the number of registered buttons </summary>
+	byte count;
+	/// <summary> set by wake() to cut the sleep short </summary>
+	volatile bool woken;
+
+	/// <summary> Calls nextEventIn() of a button of type B </summary>
+	template < class B >
+	static time_type nextEventOf(const void *button, time_type now)
+	{
+		return static_cast<const B *>(button)->nextEventIn(now);
+	}
+
+public:
+	/// <summary> PushButtonSleepManager constructor </summary>
+	PushButtonSleepManager() : count(0), woken(false)
+	{ }
+
+	/// <summary> Registers a button </summary>
+	/// <param name="button"> The button (has to use the same HAL) </param>
+	/// <returns> false if there is no room for more buttons </returns>
+	template < class B >
+	bool add(const B &button)
+	{
+		if (count >= N)
+			return false;
+		buttons[count].button = &button;
+		buttons[count].nextEventIn = &nextEventOf<B>;
+		count++;
+		return true;
+	}
+
+	/// <summary> The time until the earliest event of all the registered buttons </summary>
+	/// <param name="now"> The current time (HAL::now()) - the time the buttons have just been handled at </param>
+	/// <returns> the time in HAL ticks (0 if any button has work to do), or the maximum value
+	/// of time_type if only a pin change can produce the next event </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		time_type next = (time_type)~(time_type)0;
+		for (byte i = 0; i < count && next; i++)
+		{
+			time_type t = buttons[i].nextEventIn(buttons[i].button, now);
+			if (t < next)
+				next = t;
+		}
+		return next;
+	}
+
+	/// <summary> Cuts the sleep short, to be called from the pin change interrupt handler </summary>
+	void wake()
+	{
+		woken = true;
+	}
+
+	/// <summary> Idles until the earliest event of the registered buttons or until woken up </summary>
+	/// <param name="maxSleep"> The longest time in milliseconds to sleep (0 - no limit) </param>
+	/// <returns> true if woken up by wake() (a pin has changed), false if the deadline has passed </returns>
+	/// <remark> to be called after all the buttons have been handled in the loop; returns at once
+	/// if any button has work to do. The time is checked after every wake up of the MCU
+	/// (on AVR at least every timer 0 interrupt) </remark>
+	bool sleep(unsigned long maxSleep = 0)
+	{
+		time_type start = HAL::now();
+		time_type wait = nextEventIn(start);
+		if (maxSleep && HAL::toTicks(maxSleep) < wait)
+			wait = HAL::toTicks(maxSleep);
+		while (!woken && (time_type)(HAL::now() - start) < wait)
+			HAL::idle();
+		bool r = woken;
+		woken = false;
+		return r;
+	}
+};
+
+#endif
@@ -0,0 +1,619 @@
+// yaPushButtonStatic.h
+// part of yaPushButton - (yet another) set of classes for pushbutton debouncing
+// compile-time configured variants of the button classes
+// the pin, the polarity and all the timings are template parameters, so they take no RAM
+// and the comparisons are made against constants
+// (c) yaPushButton contributors, 2026
+
+#ifndef _YAPUSHBUTTONSTATIC_h
+#define _YAPUSHBUTTONSTATIC_h
+
+#include "yaPushButton.h"
+
+/// <summary>
+/// PushButtonStatic Template Class
+/// </summary>
+/// <remarks>
+/// Implements the same functionality as PushButton with the configuration fixed at compile time
+/// PIN is the pin the button is connected to, DEBOUNCE the debounce delay in milliseconds
+/// ACT determines active low = false (default)
+/// - push button that connects to GND when pressed
+/// or active high push button
+/// Takes only one timestamp and the state bits in RAM
+/// The delays are converted to HAL ticks at compile time
+/// </remarks>
+template < byte PIN, bool ACT = false, unsigned long DEBOUNCE = 50, class HAL = YAPUSHBUTTON_DEFAULT_HAL >
+class PushButtonStatic
+{
+	static_assert(DEBOUNCE <= PushButton<ACT, HAL>::maxDelay(), "DEBOUNCE is too long for the time_type of the HAL");
+
+public:
+	/// <summary> the type the timestamps are kept in (HAL ticks) </summary>
+	typedef typename HAL::time_type time_type;
+	/// <summary> the hardware access policy of the button </summary>
+	typedef HAL hal_type;
+
+protected:
+	/// <summary> the last time the state of the button changed </summary>
+	time_type stateChangedTimeStamp;
+	/// <summary> true while waiting for button to stabilize - waiting for the debounce time to pass </summary>
+	bool debounceWaiting : 1;
+	/// <summary> the previous state of the button </summary>
+	bool previousButtonState : 1;
+	/// <summary> used for autorepeat feature in derived classes but allocated here as bit field to save memory </summary>
+	bool singlePress : 1;
+
+public:
+	/// <summary> PushButtonStatic constructor </summary>
+	PushButtonStatic() : stateChangedTimeStamp(0), debounceWaiting(false), previousButtonState(false), singlePress(false)
+	{ }
+
+	/// <summary> initializes the PushButtonStatic object </summary>
+	void init()
+	{
+		HAL::setupPin(PIN, ACT ? INPUT : INPUT_PULLUP);
+		debounceWaiting = false; // not in debounce
+		previousButtonState = false; // not pressed
+		singlePress = false;
+	}
+
+	/// <summary> Gets the debouncing delay </summary>
+	/// <returns> the debouncing delay in milliseconds </returns>
+	static unsigned long getDebounceDelay()
+	{
+		return DEBOUNCE;
+	}
+
+	/// <summary> Is the button (held) pressed or not </summary>
+	/// <returns> true if the button is pressed in the moment </returns>
+	bool isPressed()
+	{
+		return ACT ? HAL::readPin(PIN) : !HAL::readPin(PIN);
+	}
+
+	/// <summary> Detect state change of a button </summary>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	/// <remark> same as PushButton::stateChanged() - to be called repeatedly in a loop </remark>
+	byte stateChanged()
+	{
+		return stateChanged(HAL::now());
+	}
+
+	/// <summary> Detect state change of a button at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> BUTTON_PRESSED, BUTTON_RELEASED or BUTTON_NOCHANGE </returns>
+	byte stateChanged(time_type now)
+	{
+		byte r = BUTTON_NOCHANGE;
+		bool currentButtonState = isPressed();
+
+		if (debounceWaiting)
+		{
+			if ((time_type)(now - stateChangedTimeStamp) > HAL::toTicks(DEBOUNCE))
+			{
+				if (previousButtonState ^ currentButtonState)
+					r = (previousButtonState << 1) | currentButtonState;
+				debounceWaiting = false;
+				previousButtonState = currentButtonState;
+			}
+		}
+		else if (previousButtonState ^ currentButtonState)
+		{
+			debounceWaiting = true;
+			stateChangedTimeStamp = now;
+		}
+		return r;
+	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until the debounce period expires (0 if it already has) 
+	/// or the maximum value of time_type if only a press or release can produce the next event </returns>
+	/// <remark> same as PushButton::nextEventIn() </remark>
+	time_type nextEventIn(time_type now) const
+	{
+		if (debounceWaiting)
+			return PushButton<ACT, HAL>::untilElapsed(now, stateChangedTimeStamp, HAL::toTicks(DEBOUNCE));
+		return PushButton<ACT, HAL>::maxTime();
+	}
+
+	/// <summary> Is the button down (debounced) </summary>
+	/// <returns> true while the button is (debounced) pressed </returns>
+	bool isDown() const
+	{
+		return previousButtonState;
+	}
+
+	/// <summary> The time the last state change of the button was spotted </summary>
+	/// <returns> the time (HAL ticks) of the edge that started the debouncing - once the change is reported, the time it happened </returns>
+	time_type getStateChangedTime() const
+	{
+		return stateChangedTimeStamp;
+	}
+
+	/// <summary> Is the button idle - released and not waiting for the debounce time to pass </summary>
+	/// <returns> true if only pressing the button can produce the next event </returns>
+	bool isIdle() const
+	{
+		return !debounceWaiting && !previousButtonState;
+	}
+};
+
+/// <summary>
+/// PushButtonAutoRepeatStatic Template Class
+/// </summary>
+/// <remarks>
+/// Implements the same functionality as PushButtonAutoRepeat with the configuration fixed at compile time
+/// REPEAT_DELAY - the delay in milliseconds before autorepeat begins
+/// REPEAT_PERIOD - the period in milliseconds at which a new keypress will be automatically produced
+/// CATCHUP - what is fired when handle() is called too late for more than one keypress (ButtonCatchUp)
+/// In RAM besides the state and the timestamps: the event callback and the keypress callback sharing the
+/// storage with its context, and the repeat count of ButtonEvent - 4 bytes more on AVR than the keypress callback alone
+/// </remarks>
+template < byte PIN, bool ACT = false, unsigned long REPEAT_DELAY = 500, unsigned long REPEAT_PERIOD = 200,
+	unsigned long DEBOUNCE = 50, class HAL = YAPUSHBUTTON_DEFAULT_HAL, byte CATCHUP = BUTTON_CATCHUP_SKIP >
+class PushButtonAutoRepeatStatic : public PushButtonStatic<PIN, ACT, DEBOUNCE, HAL>
+{
+	static_assert(REPEAT_DELAY <= PushButton<ACT, HAL>::maxDelay() && REPEAT_PERIOD <= PushButton<ACT, HAL>::maxDelay(), 
+		"REPEAT_DELAY and REPEAT_PERIOD are too long for the time_type of the HAL");
+
+	typedef PushButtonStatic<PIN, ACT, DEBOUNCE, HAL> Base;
+
+public:
+	/// <summary> the type the timestamps are kept in (HAL ticks) </summary>
+	typedef typename HAL::time_type time_type;
+
+protected:
+	/// <summary> the function to be called on each keypress event with the context and the event (if set) </summary>
+	void(*keyEventCallback)(void *context, ButtonEvent event);
+	union
+	{
+		/// <summary> the function to be called on each keypress event (if keyEventCallback is not set) </summary>
+		void(*keyPressCallback)();
+		/// <summary> the context passed to keyEventCallback (only while keyEventCallback is set) </summary>
+		void *callbackContext;
+	};
+	/// <summary> the time the first keypress has been fired, then the tick before the last autorepeated keypress was due </summary>
+	time_type lastChangeTime;
+	/// <summary> the number of keypresses autorepeated since the button has been pressed </summary>
+	unsigned int repeatCount;
+
+	/// <summary> Makes the event for the next keypress and counts the repeats </summary>
+	/// <param name="kind"> BUTTON_EVENT_PRESS, BUTTON_EVENT_REPEAT or BUTTON_EVENT_ACCELERATED_REPEAT </param>
+	/// <param name="count"> The number of keypresses the event stands for </param>
+	/// <returns> the event to be reported </returns>
+	ButtonEvent nextEvent(byte kind, unsigned int count = 1)
+	{
+		if (kind == BUTTON_EVENT_PRESS)
+			repeatCount = 0;
+		else
+			repeatCount += count;
+		ButtonEvent e;
+		e.kind = kind;
+		e.repeatIndex = repeatCount;
+		e.count = count;
+		return e;
+	}
+
+	/// <summary> Reads the button and fires the first keypress </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="fired"> Set to true if the first keypress has been fired in this call </param>
+	/// <param name="f"> Called with the event if the keypress is fired </param>
+	/// <returns> the time in HAL ticks the button is being held pressed </returns>
+	template < class F >
+	time_type handleFirstPress(time_type now, bool &fired, F &f)
+	{
+		time_type bpDur = heldDown(now); // will return value > 0 if the button is pressed
+		fired = !Base::singlePress && bpDur;
+		if (fired) // first notice of this keypress
+		{
+			f(nextEvent(BUTTON_EVENT_PRESS));
+			Base::singlePress = true;
+			lastChangeTime = now;
+		}
+		if (bpDur == 0) // button is released
+			Base::singlePress = false;
+		return bpDur;
+	}
+
+	/// <summary> Fires the autorepeated keypresses due at the given period </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="period"> The autorepeat period in HAL ticks </param>
+	/// <param name="held"> For how long the button has been held pressed </param>
+	/// <param name="delay"> For how long the button has to be held before the keypresses at this period start </param>
+	/// <param name="kind"> BUTTON_EVENT_REPEAT or BUTTON_EVENT_ACCELERATED_REPEAT </param>
+	/// <param name="f"> Called with the events </param>
+	/// <returns> the number of keypresses fired (counted with BUTTON_CATCHUP_COUNT), 0 if none was due </returns>
+	/// <remark> the schedule of PushButtonAutoRepeat (PushButtonRepeatSchedule) with the catch-up policy CATCHUP </remark>
+	template < class F >
+	unsigned int repeatEvery(time_type now, time_type period, time_type held, time_type delay, byte kind, F &f)
+	{
+		typename PushButtonRepeatSchedule<time_type>::Steady steps = { period, kind };
+		return repeatOn(now, held, delay, steps, f);
+	}
+
+	/// <summary> Fires the autorepeated keypresses due on a schedule that may change with each keypress </summary>
+	/// <param name="now"> The current time </param>
+	/// <param name="held"> For how long the button has been held pressed </param>
+	/// <param name="delay"> For how long the button has to be held before the keypresses on this schedule start </param>
+	/// <param name="steps"> The schedule (see PushButtonRepeatSchedule::run()) </param>
+	/// <param name="f"> Called with the events </param>
+	/// <returns> the number of keypresses fired (counted with BUTTON_CATCHUP_COUNT), 0 if none was due </returns>
+	template < class S, class F >
+	unsigned int repeatOn(time_type now, time_type held, time_type delay, S &steps, F &f)
+	{
+		time_type late;
+		return PushButtonRepeatSchedule<time_type>::run(now, held, delay, lastChangeTime, late, CATCHUP, steps,
+			[&](byte kind, unsigned int count) { f(nextEvent(kind, count)); });
+	}
+
+public:
+	/// <summary> PushButtonAutoRepeatStatic constructor </summary>
+	/// <param name="KeyPressCallBackFunction"> The function to be called on each keypress </param>
+	PushButtonAutoRepeatStatic(void(*KeyPressCallBackFunction)() = NULL) : 
+		keyEventCallback(NULL), keyPressCallback(KeyPressCallBackFunction), lastChangeTime(0), repeatCount(0)
+	{ }
+
+	/// <summary> Registers the callback function to be called on each keypress </summary>
+	/// <param name="keyPressFunction"> The function to be called on each keypress </param>
+	void registerKeyPressCallback(void(*keyPressFunction)())
+	{
+		keyEventCallback = NULL;
+		keyPressCallback = keyPressFunction;
+	}
+
+	/// <summary> Registers the callback function to be called on each keypress with a context and the event </summary>
+	/// <param name="keyEventFunction"> The function to be called on each keypress </param>
+	/// <param name="context"> The pointer passed to the function (any user data) </param>
+	/// <remark> NULL for the function unregisters both callbacks </remark>
+	void registerKeyEventCallback(void(*keyEventFunction)(void *, ButtonEvent), void *context)
+	{
+		keyEventCallback = keyEventFunction;
+		if (keyEventFunction)
+			callbackContext = context;
+		else // the context shares the storage with keyPressCallback - it must not be left there to be called
+			keyPressCallback = NULL;
+	}
+
+	/// <summary> Calls the registered callback function </summary>
+	/// <param name="event"> The keypress to be reported </param>
+	void fire(ButtonEvent event)
+	{
+		if (keyEventCallback)
+			keyEventCallback(callbackContext, event);
+		else if (keyPressCallback)
+			keyPressCallback();
+	}
+
+	/// <summary> Functor calling the registered callback function (used by handle(now)) </summary>
+	struct Callback
+	{
+		PushButtonAutoRepeatStatic *button;
+		void operator()(ButtonEvent event) const
+		{
+			button->fire(event);
+		}
+	};
+
+	/// <summary> Gets the delay the button has to be hold pressed before autorepeat starts </summary>
+	/// <returns> The delay in milliseconds before autorepeat begins </returns>
+	static unsigned long getRepeatDelay()
+	{
+		return REPEAT_DELAY;
+	}
+
+	/// <summary> Gets the period at which a new keypress will be automatically produced</summary>
+	/// <returns> The period in milliseconds at which a new keypress is automatically produced </returns>
+	static unsigned long getRepeatPeriod()
+	{
+		return REPEAT_PERIOD;
+	}
+
+	/// <summary> For how long the button has been held pressed </summary>
+	/// <returns> the time in HAL ticks the button is being held pressed </returns>
+	/// <remark> same as PushButtonAutoRepeat::heldDown() </remark>
+	time_type heldDown()
+	{
+		return heldDown(HAL::now());
+	}
+
+	/// <summary> For how long the button has been held pressed at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <returns> the time in HAL ticks the button is being held pressed </returns>
+	time_type heldDown(time_type now)
+	{
+		time_type r = 0;
+		bool currentButtonState = this->isPressed();
+
+		if (Base::debounceWaiting)
+		{
+			time_type duration = (time_type)(now - Base::stateChangedTimeStamp);
+			if (duration > HAL::toTicks(DEBOUNCE))
+			{
+				if (!Base::previousButtonState && currentButtonState)
+					r = duration;
+				Base::debounceWaiting = false;
+				Base::previousButtonState = currentButtonState;
+			}
+		}
+		else if (Base::previousButtonState ^ currentButtonState)
+		{
+			Base::debounceWaiting = true;
+			Base::stateChangedTimeStamp = now;
+		}
+		else if (currentButtonState) // was and still is down (being held pressed)
+			r = PushButtonRepeatSchedule<time_type>::held(now, Base::stateChangedTimeStamp);
+		return r;
+	}
+
+	/// <summary> To be called repeatedly in a loop (services auto repeating calls) </summary>
+	void handle()
+	{
+		handle(HAL::now());
+	}
+
+	/// <summary> Services auto repeating calls at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(time_type now)
+	{
+		Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Services auto repeating at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the ButtonEvent on each keypress instead of the callback </param>
+	template < class F >
+	void handle(time_type now, F &&f)
+	{
+		bool fired;
+		time_type bpDur = handleFirstPress(now, fired, f);
+		repeatEvery(now, HAL::toTicks(REPEAT_PERIOD), bpDur, HAL::toTicks(REPEAT_DELAY), BUTTON_EVENT_REPEAT, f);
+	}
+
+	/// <summary> For how long the button has been held pressed (without reading the button) </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks the button has been held pressed, 0 if it is not </returns>
+	time_type heldFor(time_type now) const
+	{
+		if (Base::debounceWaiting || !Base::previousButtonState)
+			return 0;
+		return (time_type)(now - Base::stateChangedTimeStamp);
+	}
+
+	/// <summary> The time until the next keypress would be fired at the given repeat period </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <param name="period"> The autorepeat period in HAL ticks </param>
+	/// <returns> the time in HAL ticks (0 if due), the maximum value of time_type if the button is not being held pressed </returns>
+	time_type nextRepeatIn(time_type now, time_type period) const
+	{
+		typedef PushButton<ACT, HAL> PB;
+		if (Base::debounceWaiting || !Base::previousButtonState) // waiting to stabilize or released
+			return Base::nextEventIn(now);
+		if (!Base::singlePress) // the first keypress has not been fired yet
+			return 0;
+		time_type toDelay = PB::untilElapsed(now, Base::stateChangedTimeStamp, HAL::toTicks(REPEAT_DELAY));
+		time_type toPeriod = PB::untilElapsed(now, lastChangeTime, period);
+		return toDelay > toPeriod ? toDelay : toPeriod;
+	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until debounce expires or the next autorepeat keypress (0 if due), 
+	/// or the maximum value of time_type if only a press or release can produce the next event </returns>
+	time_type nextEventIn(time_type now) const
+	{
+		return nextRepeatIn(now, HAL::toTicks(REPEAT_PERIOD));
+	}
+};
+
+/// <summary>
+/// PushButton2SpeedAutoRepeatStatic Template Class
+/// </summary>
+/// <remarks>
+/// Implements the same functionality as PushButton2SpeedAutoRepeat with the configuration fixed at compile time
+/// REPEAT_DELAY_ACC - the delay in milliseconds before autorepeat switches to faster speed (greater than REPEAT_DELAY)
+/// REPEAT_PERIOD_ACC - the period in milliseconds for autorepeat at faster speed
+/// </remarks>
+template < byte PIN, bool ACT = false, unsigned long REPEAT_DELAY = 500, unsigned long REPEAT_PERIOD = 200,
+	unsigned long REPEAT_DELAY_ACC = 2000, unsigned long REPEAT_PERIOD_ACC = 50,
+	unsigned long DEBOUNCE = 50, class HAL = YAPUSHBUTTON_DEFAULT_HAL, byte CATCHUP = BUTTON_CATCHUP_SKIP >
+class PushButton2SpeedAutoRepeatStatic : public PushButtonAutoRepeatStatic<PIN, ACT, REPEAT_DELAY, REPEAT_PERIOD, DEBOUNCE, HAL, CATCHUP>
+{
+	static_assert(REPEAT_DELAY_ACC > REPEAT_DELAY, "REPEAT_DELAY_ACC has to be greater than REPEAT_DELAY");
+	static_assert(REPEAT_DELAY_ACC <= PushButton<ACT, HAL>::maxDelay() && REPEAT_PERIOD_ACC <= PushButton<ACT, HAL>::maxDelay(), 
+		"REPEAT_DELAY_ACC and REPEAT_PERIOD_ACC are too long for the time_type of the HAL");
+
+public:
+	/// <summary> PushButton2SpeedAutoRepeatStatic constructor </summary>
+	/// <param name="KeyPressCallBackFunction"> The function to be called on each keypress </param>
+	PushButton2SpeedAutoRepeatStatic(void(*KeyPressCallBackFunction)() = NULL) :
+		PushButtonAutoRepeatStatic<PIN, ACT, REPEAT_DELAY, REPEAT_PERIOD, DEBOUNCE, HAL, CATCHUP>(KeyPressCallBackFunction)
+	{ }
+
+	/// <summary> Gets the delay the button has to be held pressed before accelerated autorepeat begins </summary>
+	/// <returns> The delay in milliseconds before accelerated autorepeat begins </returns>
+	static unsigned long getRepeatAccelerateDelay()
+	{
+		return REPEAT_DELAY_ACC;
+	}
+
+	/// <summary> Gets the period at which a new keypress is automatically produced in accelerated speed </summary>
+	/// <returns> The period in milliseconds at which a new keypress is automatically produced in accelerated speed </returns>
+	static unsigned long getRepeatPeriodAcc()
+	{
+		return REPEAT_PERIOD_ACC;
+	}
+
+	/// <summary> To be called repeatedly in a loop (services auto repeating calls) </summary>
+	/// <remark> after REPEAT_DELAY_ACC milliseconds starts to autorepeat at faster speed </remark>
+	void handle()
+	{
+		handle(HAL::now());
+	}
+
+	/// <summary> Services auto repeating calls at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(typename HAL::time_type now)
+	{
+		typename PushButtonAutoRepeatStatic<PIN, ACT, REPEAT_DELAY, REPEAT_PERIOD, DEBOUNCE, HAL, CATCHUP>::Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Services auto repeating at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the ButtonEvent on each keypress instead of the callback </param>
+	template < class F >
+	void handle(typename HAL::time_type now, F &&f)
+	{
+		bool fired;
+		typename HAL::time_type bpDur = this->handleFirstPress(now, fired, f);
+		if (bpDur > HAL::toTicks(REPEAT_DELAY_ACC))
+		{
+			typedef typename HAL::time_type time_type;
+			time_type pastAcc = (time_type)(bpDur - HAL::toTicks(REPEAT_DELAY_ACC));
+			if ((time_type)(now - this->lastChangeTime) > pastAcc) // the keypresses at slow speed due until the switch (a late call)
+				this->repeatEvery((time_type)(now - pastAcc), HAL::toTicks(REPEAT_PERIOD), HAL::toTicks(REPEAT_DELAY_ACC), 
+					HAL::toTicks(REPEAT_DELAY), BUTTON_EVENT_REPEAT, f);
+			this->repeatEvery(now, HAL::toTicks(REPEAT_PERIOD_ACC), bpDur, HAL::toTicks(REPEAT_DELAY_ACC), BUTTON_EVENT_ACCELERATED_REPEAT, f);
+		}
+		else
+			this->repeatEvery(now, HAL::toTicks(REPEAT_PERIOD), bpDur, HAL::toTicks(REPEAT_DELAY), BUTTON_EVENT_REPEAT, f);
+	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until debounce expires or the next autorepeat keypress (0 if due), 
+	/// or the maximum value of time_type if only a press or release can produce the next event </returns>
+	typename HAL::time_type nextEventIn(typename HAL::time_type now) const
+	{
+		typedef typename HAL::time_type time_type;
+		time_type held = this->heldFor(now);
+		if (held > HAL::toTicks(REPEAT_DELAY_ACC)) // already at faster speed
+			return this->nextRepeatIn(now, HAL::toTicks(REPEAT_PERIOD_ACC));
+		time_type slow = this->nextRepeatIn(now, HAL::toTicks(REPEAT_PERIOD));
+		if (!held)
+			return slow;
+		// may switch to faster speed before the next keypress at slow speed
+		time_type toAcc = (time_type)(HAL::toTicks(REPEAT_DELAY_ACC) - held + 1);
+		time_type fast = this->nextRepeatIn(now, HAL::toTicks(REPEAT_PERIOD_ACC));
+		if (fast < toAcc)
+			fast = toAcc;
+		return fast < slow ? fast : slow;
+	}
+};
+
+/// <summary>
+/// PushButtonAutoAcceleratedRepeatStatic Template Class
+/// </summary>
+/// <remarks>
+/// Implements the same functionality as PushButtonAutoAcceleratedRepeat with the configuration fixed at compile time
+/// REPEAT_DELAY_ACC - the delay in milliseconds before autorepeat starts to accelerate (greater than REPEAT_DELAY)
+/// REPEAT_ACC - the milliseconds the repeat period is shortened by on each repeat
+/// REPEAT_MIN_PERIOD - the period in milliseconds below which it will not accelerate
+/// The current period is kept in HAL ticks, but at most 16 bits
+/// </remarks>
+template < byte PIN, bool ACT = false, unsigned long REPEAT_DELAY = 500, unsigned long REPEAT_PERIOD = 200,
+	unsigned long REPEAT_DELAY_ACC = 2000, unsigned long REPEAT_ACC = 10, unsigned long REPEAT_MIN_PERIOD = 20,
+	unsigned long DEBOUNCE = 50, class HAL = YAPUSHBUTTON_DEFAULT_HAL, byte CATCHUP = BUTTON_CATCHUP_SKIP >
+class PushButtonAutoAcceleratedRepeatStatic : public PushButtonAutoRepeatStatic<PIN, ACT, REPEAT_DELAY, REPEAT_PERIOD, DEBOUNCE, HAL, CATCHUP>
+{
+	static_assert(REPEAT_DELAY_ACC > REPEAT_DELAY, "REPEAT_DELAY_ACC has to be greater than REPEAT_DELAY");
+	static_assert(HAL::toTicks(REPEAT_PERIOD) <= 0xFFFFUL, "REPEAT_PERIOD has to fit in 16 bits");
+	static_assert(REPEAT_DELAY_ACC <= PushButton<ACT, HAL>::maxDelay() && REPEAT_PERIOD + REPEAT_MIN_PERIOD <= PushButton<ACT, HAL>::maxDelay(), 
+		"REPEAT_DELAY_ACC and REPEAT_PERIOD + REPEAT_MIN_PERIOD are too long for the time_type of the HAL");
+
+protected:
+	/// <summary> the current period for autorepeat (in HAL ticks) </summary>
+	unsigned int currentRepeatPeriod;
+
+	/// <summary> The accelerating schedule - the period is shortened after each keypress due (PushButtonRepeatSchedule::run()) </summary>
+	struct Steps
+	{
+		PushButtonAutoAcceleratedRepeatStatic *button;
+		typename HAL::time_type period() const
+		{
+			return (typename HAL::time_type)(button->currentRepeatPeriod + HAL::toTicks(REPEAT_MIN_PERIOD));
+		}
+		byte kind() const
+		{
+			return button->currentRepeatPeriod < HAL::toTicks(REPEAT_PERIOD) ? BUTTON_EVENT_ACCELERATED_REPEAT : BUTTON_EVENT_REPEAT;
+		}
+		bool step()
+		{
+			if (!HAL::toTicks(REPEAT_ACC) || button->currentRepeatPeriod < HAL::toTicks(REPEAT_ACC)) // no longer accelerating
+				return false;
+			button->currentRepeatPeriod -= HAL::toTicks(REPEAT_ACC);
+			return true;
+		}
+	};
+
+public:
+	/// <summary> PushButtonAutoAcceleratedRepeatStatic constructor </summary>
+	/// <param name="KeyPressCallBackFunction"> The function to be called on each keypress </param>
+	PushButtonAutoAcceleratedRepeatStatic(void(*KeyPressCallBackFunction)() = NULL) :
+		PushButtonAutoRepeatStatic<PIN, ACT, REPEAT_DELAY, REPEAT_PERIOD, DEBOUNCE, HAL, CATCHUP>(KeyPressCallBackFunction),
+		currentRepeatPeriod(HAL::toTicks(REPEAT_PERIOD))
+	{ }
+
+	/// <summary> Gets the delay the button has to be held pressed before accelerated autorepeat begins </summary>
+	/// <returns> The delay in milliseconds before accelerated autorepeat begins </returns>
+	static unsigned long getRepeatAccelerateDelay()
+	{
+		return REPEAT_DELAY_ACC;
+	}
+
+	/// <summary> Gets the acceleration rate </summary>
+	/// <returns> The acceleration (in milliseconds decremented in each step) </returns>
+	static unsigned long getRepeatAcc()
+	{
+		return REPEAT_ACC;
+	}
+
+	/// <summary> Gets the minimum period at which a new keypress is automatically produced </summary>
+	/// <returns> The period in milliseconds </returns>
+	static unsigned long getRepeatMinPeriod()
+	{
+		return REPEAT_MIN_PERIOD;
+	}
+
+	/// <summary> To be called repeatedly in a loop (services auto repeating calls) </summary>
+	/// <remark> same as PushButtonAutoAcceleratedRepeat::handle() </remark>
+	void handle()
+	{
+		handle(HAL::now());
+	}
+
+	/// <summary> Services auto repeating calls at the given time </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	void handle(typename HAL::time_type now)
+	{
+		typename PushButtonAutoRepeatStatic<PIN, ACT, REPEAT_DELAY, REPEAT_PERIOD, DEBOUNCE, HAL, CATCHUP>::Callback c = { this };
+		handle(now, c);
+	}
+
+	/// <summary> Services auto repeating at the given time reporting the keypresses to a functor </summary>
+	/// <param name="now"> The current time (HAL::now()) - sample it once and pass it to all the buttons in a scan </param>
+	/// <param name="f"> Function, functor or lambda called with the ButtonEvent on each keypress instead of the callback </param>
+	template < class F >
+	void handle(typename HAL::time_type now, F &&f)
+	{
+		bool fired;
+		typename HAL::time_type bpDur = this->handleFirstPress(now, fired, f);
+		if (fired) // start from the initial period on each new keypress
+			currentRepeatPeriod = HAL::toTicks(REPEAT_PERIOD);
+		Steps steps = { this };
+		this->repeatOn(now, bpDur, HAL::toTicks(REPEAT_DELAY), steps, f);
+	}
+
+	/// <summary> The time until the next event the button can produce unless its pin changes </summary>
+	/// <param name="now"> The current time (HAL::now()) </param>
+	/// <returns> the time in HAL ticks until debounce expires or the next autorepeat keypress (0 if due), 
+	/// or the maximum value of time_type if only a press or release can produce the next event </returns>
+	typename HAL::time_type nextEventIn(typename HAL::time_type now) const
+	{
+		return this->nextRepeatIn(now, (typename HAL::time_type)(currentRepeatPeriod + HAL::toTicks(REPEAT_MIN_PERIOD)));
+	}
+};
+
+#endif